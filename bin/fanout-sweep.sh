@@ -0,0 +1,58 @@
+#!/bin/bash
+#********************************************************************************
+# Copyright (c) 2024 Contributors to the Eclipse Foundation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# SPDX-License-Identifier: Apache-2.0
+#*******************************************************************************
+# Fan-out scaling sweep: runs hello_service and "hello_client --clients N" on localhost
+# for each N and prints aggregate delivery, client latency skew and service notify CPU.
+# Meant to be executed from ${CMAKE_INSTALL_PREFIX}/bin
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+
+CLIENTS="${CLIENTS:-1 2 4 8 16 32 64 128 256}"
+# seconds to receive events for each N
+DURATION="${DURATION:-10}"
+# hello_service --rate (Timer_1ms field notifications/s)
+RATE="${RATE:-1k}"
+LOG_DIR="${LOG_DIR:-/tmp/hello_fanout}"
+
+mkdir -p "$LOG_DIR"
+echo "# clients: [$CLIENTS], duration: ${DURATION}s, rate: $RATE, logs: $LOG_DIR"
+
+strip_colors() {
+    sed 's/\x1b\[[0-9;]*m//g'
+}
+
+for n in $CLIENTS; do
+    (
+        . "$SCRIPT_DIR/setup-service.sh" > /dev/null
+        DEBUG=0 exec "$SCRIPT_DIR/hello_service" --rate "$RATE" --event-clock monotonic
+    ) > "$LOG_DIR/service_$n.log" 2>&1 &
+    service_pid=$!
+    sleep 2
+
+    (
+        . "$SCRIPT_DIR/setup-client-proxy.sh" > /dev/null
+        exec timeout -s INT "$DURATION" "$SCRIPT_DIR/hello_client" --sub --clients "$n"
+    ) > "$LOG_DIR/client_$n.log" 2>&1
+
+    kill -INT "$service_pid"
+    wait "$service_pid"
+
+    echo
+    echo "### clients: $n"
+    grep -A5 "### Fan-out" "$LOG_DIR/client_$n.log" | grep -- "  - " | strip_colors
+    grep "notify_event()" "$LOG_DIR/service_$n.log" | strip_colors
+done
@@ -0,0 +1,673 @@
+/*
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <iomanip>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <vsomeip/vsomeip.hpp>
+
+#include "byteorder.hpp"
+
+#include "hello_codec.h"
+#include "hello_log.h"
+#include "hello_proto.h"
+#include "hello_stats.h"
+#include "hello_utils.h"
+#include "mpsc_queue.h"
+#include "notify_batcher.h"
+#include "timer.h"
+
+// number of iterations per benchmark
+static int iterations = ::getenv("BENCH_ITERATIONS") ? ::atoi(::getenv("BENCH_ITERATIONS")) : 1000000;
+// timer expirations per timer benchmark
+static int timer_ticks = ::getenv("BENCH_TIMER_TICKS") ? ::atoi(::getenv("BENCH_TIMER_TICKS")) : 2000;
+
+// global allocation counter, updated by replaced operator new
+static std::atomic<uint64_t> alloc_count(0);
+
+void* operator new(std::size_t size) {
+    alloc_count.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace HelloExample {
+
+// prevents the compiler from optimizing away benchmarked results
+template<typename T>
+inline void do_not_optimize(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template<typename F>
+void run_bench(const char* name, F fn) {
+    for (int i = 0; i < iterations / 100 + 1; i++) fn(); // warm up
+    uint64_t allocs = alloc_count.load();
+    auto ts = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        fn();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - ts;
+    allocs = alloc_count.load() - allocs;
+    std::printf("  %-40s %10.1f ns/op %8.2f allocs/op\n", name,
+            elapsed.count() / iterations, allocs / (double)iterations);
+}
+
+// Previous serialize_hello_event() implementation, kept as a reference for comparison
+static void serialize_int32_vector(const int32_t value, std::vector<vsomeip::byte_t>& data) {
+    data.push_back(VSOMEIP_LONG_BYTE3(value));
+    data.push_back(VSOMEIP_LONG_BYTE2(value));
+    data.push_back(VSOMEIP_LONG_BYTE1(value));
+    data.push_back(VSOMEIP_LONG_BYTE0(value));
+}
+
+static bool serialize_hello_event_vector(const HelloEvent& event, std::shared_ptr<vsomeip::payload> payload) {
+    std::vector<vsomeip::byte_t> data;
+    serialize_int32_vector(event.time_of_day.hours, data);
+    serialize_int32_vector(event.time_of_day.minutes, data);
+    serialize_int32_vector(event.time_of_day.seconds, data);
+    serialize_int32_vector(event.time_of_day.nanos, data);
+    data.push_back(static_cast<vsomeip::byte_t>(event.timer_id));
+    payload->set_data(data);
+    return true;
+}
+
+// Hand-written in-place encoder with constexpr offsets, kept as a reference for the generated codec
+static inline void store_be32(vsomeip::byte_t* dst, int32_t value) {
+    uint32_t be = __builtin_bswap32(static_cast<uint32_t>(value));
+    std::memcpy(dst, &be, sizeof(be));
+}
+
+static void serialize_hello_event_manual(const HelloEvent& event, vsomeip::byte_t* buffer) {
+    store_be32(buffer + 0, event.time_of_day.hours);
+    store_be32(buffer + 4, event.time_of_day.minutes);
+    store_be32(buffer + 8, event.time_of_day.seconds);
+    store_be32(buffer + 12, event.time_of_day.nanos);
+    buffer[16] = static_cast<vsomeip::byte_t>(event.timer_id);
+}
+
+// Previous index based decoder, kept as a reference for the generated codec
+static int32_t deserialize_int32_index(const vsomeip::byte_t* data, const uint32_t data_size, uint32_t &index) {
+    if (index + 4 >= data_size) {
+        return -1;
+    }
+    uint32_t value = VSOMEIP_BYTES_TO_LONG(data[index + 0], data[index + 1], data[index + 2], data[index + 3]);
+    index = index + 4;
+    return value;
+}
+
+static bool deserialize_hello_event_index(HelloEvent &event, const vsomeip::byte_t* data, uint32_t size) {
+    if (size < HELLO_EVENT_PAYLOAD_SIZE) {
+        return false;
+    }
+    uint32_t index = 0;
+    event.time_of_day.hours = deserialize_int32_index(data, size, index);
+    event.time_of_day.minutes = deserialize_int32_index(data, size, index);
+    event.time_of_day.seconds = deserialize_int32_index(data, size, index);
+    event.time_of_day.nanos = deserialize_int32_index(data, size, index);
+    event.timer_id = static_cast<TimerID>(data[index++]);
+    return (index == HELLO_EVENT_PAYLOAD_SIZE);
+}
+
+void bench_serialize_event() {
+    std::shared_ptr<vsomeip::payload> payload = vsomeip::runtime::get()->create_payload();
+    HelloEvent event = { { 12, 34, 56, 789012345 }, Timer_1ms };
+
+    run_bench("serialize_hello_event (vector)", [&] {
+        event.time_of_day.nanos++;
+        serialize_hello_event_vector(event, payload);
+        do_not_optimize(payload->get_data()[0]);
+    });
+    run_bench("serialize_hello_event (payload)", [&] {
+        event.time_of_day.nanos++;
+        serialize_hello_event(event, payload);
+        do_not_optimize(payload->get_data()[0]);
+    });
+    vsomeip::byte_t buffer[HELLO_EVENT_PAYLOAD_SIZE];
+    run_bench("serialize_hello_event (hand-written)", [&] {
+        event.time_of_day.nanos++;
+        serialize_hello_event_manual(event, buffer);
+        do_not_optimize(buffer[0]);
+    });
+    run_bench("serialize_hello_event (buffer)", [&] {
+        event.time_of_day.nanos++;
+        serialize_hello_event(event, buffer, sizeof(buffer));
+        do_not_optimize(buffer[0]);
+    });
+}
+
+void bench_deserialize_event() {
+    std::shared_ptr<vsomeip::payload> payload = vsomeip::runtime::get()->create_payload();
+    HelloEvent event = { { 12, 34, 56, 789012345 }, Timer_1ms };
+    serialize_hello_event(event, payload);
+
+    run_bench("deserialize_hello_event (index)", [&] {
+        deserialize_hello_event_index(event, payload->get_data(), payload->get_length());
+        do_not_optimize(event);
+    });
+    run_bench("deserialize_hello_event (codec)", [&] {
+        codec::decode(event, payload->get_data(), payload->get_length());
+        do_not_optimize(event);
+    });
+    run_bench("deserialize_hello_event (payload)", [&] {
+        deserialize_hello_event(event, payload);
+        do_not_optimize(event);
+    });
+
+    HelloEventExt event_ext = { event, 1, Clock_Monotonic, 0 };
+    run_bench("serialize_hello_event (ext)", [&] {
+        event_ext.sequence++;
+        event_ext.timestamp_ns = clock_now_ns(Clock_Monotonic);
+        serialize_hello_event(event_ext, payload);
+        do_not_optimize(payload->get_data()[0]);
+    });
+    run_bench("serialize_hello_event (ext, 1024 bytes)", [&] {
+        event_ext.sequence++;
+        serialize_hello_event(event_ext, payload, 1024);
+        do_not_optimize(payload->get_data()[0]);
+    });
+    run_bench("deserialize_hello_event (ext)", [&] {
+        deserialize_hello_event(event_ext, payload);
+        do_not_optimize(event_ext);
+    });
+    run_bench("check_payload_pattern (1024 bytes)", [&] {
+        bool ok = check_payload_pattern(payload->get_data(), HELLO_EVENT_EXT_PAYLOAD_SIZE, payload->get_length());
+        do_not_optimize(ok);
+    });
+}
+
+void bench_request_codec() {
+    std::shared_ptr<vsomeip::payload> payload = vsomeip::runtime::get()->create_payload();
+    HelloRequest request = { "HelloRequest#12345" };
+    HelloRequest decoded;
+
+    run_bench("serialize_hello_request", [&] {
+        serialize_hello_request(request, payload);
+        do_not_optimize(payload->get_data()[0]);
+    });
+    run_bench("deserialize_hello_request", [&] {
+        deserialize_hello_request(decoded, payload);
+        do_not_optimize(decoded.message[0]);
+    });
+
+    // hello_service::on_message_cb() request -> response path
+    std::shared_ptr<vsomeip::payload> resp_payload = vsomeip::runtime::get()->create_payload();
+    run_bench("say_hello (HelloRequest)", [&] {
+        HelloRequest req;
+        deserialize_hello_request(req, payload);
+        HelloResponse response = { "Hello " + req.message };
+        serialize_hello_response(response, resp_payload);
+        do_not_optimize(resp_payload->get_data()[0]);
+    });
+    run_bench("say_hello (HelloRequestView)", [&] {
+        HelloRequestView req;
+        deserialize_hello_request(req, payload);
+        static const StringView HELLO_PREFIX = { "Hello ", 6 };
+        serialize_hello_response(HELLO_PREFIX, req.message, resp_payload);
+        do_not_optimize(resp_payload->get_data()[0]);
+    });
+
+    HelloResponse response;
+    run_bench("deserialize_hello_response", [&] {
+        deserialize_hello_response(response, resp_payload);
+        do_not_optimize(response.reply[0]);
+    });
+    run_bench("deserialize_hello_response (view)", [&] {
+        HelloResponseView view;
+        deserialize_hello_response(view, resp_payload);
+        do_not_optimize(view);
+    });
+}
+
+// set_hello_event() before LocalTimeCache, as reference
+void set_hello_event_localtime(HelloEvent &event, std::chrono::high_resolution_clock::time_point tp) {
+    std::time_t current_time = std::chrono::system_clock::to_time_t(tp);
+    std::tm local_time;
+    ::localtime_r(&current_time, &local_time);
+    auto tp_ns = std::chrono::time_point_cast<std::chrono::nanoseconds>(tp);
+    event.time_of_day.hours = local_time.tm_hour;
+    event.time_of_day.minutes = local_time.tm_min;
+    event.time_of_day.seconds = local_time.tm_sec;
+    event.time_of_day.nanos = tp_ns.time_since_epoch().count() % 1000000000;
+}
+
+// Previous bytes_to_string() implementation, kept as a reference for comparison
+std::string bytes_to_string_stream(const vsomeip::byte_t *data, uint32_t length) {
+    std::stringstream ss;
+    for (uint32_t i = 0; i < length; ++i) {
+        ss << std::hex << std::setfill('0') << std::setw(2) << std::uppercase
+           << static_cast<int>(data[i]);
+        if (i < length - 1) ss << " ";
+    }
+    return ss.str();
+}
+
+/**
+ * @brief Runs fn from thread_count threads concurrently, prints wall time per iteration of one thread.
+ */
+template <typename F>
+void run_bench_threads(const char* name, int thread_count, F fn) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; t++) {
+        threads.emplace_back([&fn] {
+            for (int i = 0; i < iterations; i++) {
+                fn();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    std::printf("  %-40s %10.1f ns/op\n", name, elapsed.count() / (double)iterations);
+}
+
+void bench_event_utils() {
+    HelloEvent event = { { 12, 34, 56, 789012345 }, Timer_10ms };
+
+    run_bench("to_string(HelloEvent)", [&] {
+        event.time_of_day.nanos++;
+        std::string text = to_string(event);
+        do_not_optimize(text[0]);
+    });
+    run_bench("format_hello_event (buffer)", [&] {
+        event.time_of_day.nanos++;
+        char text[HELLO_EVENT_STR_SIZE];
+        do_not_optimize(format_hello_event(event, text));
+        do_not_optimize(text[0]);
+    });
+    run_bench("set_hello_event (localtime_r)", [&] {
+        set_hello_event_localtime(event, std::chrono::high_resolution_clock::now());
+        do_not_optimize(event);
+    });
+    run_bench("set_hello_event (cached)", [&] {
+        set_hello_event(event, std::chrono::high_resolution_clock::now());
+        do_not_optimize(event);
+    });
+    run_bench_threads("set_hello_event (localtime_r, 4 threads)", 4, [] {
+        HelloEvent local_event;
+        set_hello_event_localtime(local_event, std::chrono::high_resolution_clock::now());
+        do_not_optimize(local_event);
+    });
+    run_bench_threads("set_hello_event (cached, 4 threads)", 4, [] {
+        HelloEvent local_event;
+        set_hello_event(local_event, std::chrono::high_resolution_clock::now());
+        do_not_optimize(local_event);
+    });
+    run_bench("init_hello_event", [&] {
+        init_hello_event(event);
+        do_not_optimize(event);
+    });
+    run_bench("to_time_point(HelloEvent)", [&] {
+        auto tp = to_time_point(event);
+        do_not_optimize(tp);
+    });
+    uint32_t value = 0x8005;
+    run_bench("to_hex(uint16_t)", [&] {
+        std::string text = to_hex(value++);
+        do_not_optimize(text[0]);
+    });
+    run_bench("format_hex (buffer)", [&] {
+        char text[HEX_STR_SIZE];
+        do_not_optimize(format_hex(value++, text));
+        do_not_optimize(text[0]);
+    });
+    run_bench("to_string(TimerID)", [&] {
+        std::string text = to_string(TIMER_IDS[value++ % TIMER_COUNT]);
+        do_not_optimize(text[0]);
+    });
+    run_bench("timer_name", [&] {
+        do_not_optimize(timer_name(TIMER_IDS[value++ % TIMER_COUNT]));
+    });
+    struct event_record {
+        HelloEvent event;
+        uint32_t sequence;
+        uint32_t length;
+        int64_t latency_ns;
+        int64_t received_ns;
+        bool has_latency;
+        bool pattern_error;
+    };
+    MpscQueue<event_record> queue(4096);
+    event_record record = event_record();
+    run_bench("MpscQueue push + pop (event record)", [&] {
+        record.sequence++;
+        queue.push(record);
+        queue.pop(record);
+        do_not_optimize(record);
+    });
+
+    std::vector<vsomeip::byte_t> data(1024);
+    fill_payload_pattern(data.data(), 0, data.size());
+    for (uint32_t length : { 64u, 1024u }) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "bytes_to_string (stringstream, %u bytes)", length);
+        run_bench(name, [&] {
+            std::string text = bytes_to_string_stream(data.data(), length);
+            do_not_optimize(text[0]);
+        });
+        std::snprintf(name, sizeof(name), "bytes_to_string (%s, %u bytes)", to_string(hex_dump_best()), length);
+        run_bench(name, [&] {
+            std::string text = bytes_to_string(data.data(), length, length);
+            do_not_optimize(text[0]);
+        });
+    }
+    std::vector<char> text(hex_dump_size(data.size(), data.size()));
+    for (HexDumpImpl impl : { HexDump_Scalar, HexDump_SSSE3, HexDump_AVX2 }) {
+        if (!hex_dump_select(impl)) continue;
+        char name[64];
+        std::snprintf(name, sizeof(name), "hex_dump (%s, 1024 bytes)", to_string(impl));
+        run_bench(name, [&] {
+            data[0]++;
+            do_not_optimize(hex_dump(data.data(), data.size(), text.data(), data.size()));
+            do_not_optimize(text[0]);
+        });
+    }
+    hex_dump_select(hex_dump_best());
+    run_bench("bytes_to_string (1024 bytes, limit 96)", [&] {
+        std::string dump = bytes_to_string(data.data(), data.size());
+        do_not_optimize(dump[0]);
+    });
+}
+
+// on_message() debug line fields, as returned by the vsomeip::message getters
+struct message_header {
+    vsomeip::message_type_e type;
+    uint16_t service, instance, method, client, session;
+    uint32_t length;
+};
+
+// same as hello_client format_on_message()
+static uint32_t format_on_message(const uint64_t* args, char* out, uint32_t size) {
+    int length = std::snprintf(out, size,
+            "%s[on_message] Received a %s from Service [%04x.%04x.%04x] to Client/Session [%04x/%04x] = (%u) %s\n",
+            COL_YELLOW.c_str(), to_string(static_cast<vsomeip::message_type_e>(args[0])).c_str(),
+            (unsigned)args[1], (unsigned)args[2], (unsigned)args[3], (unsigned)args[4], (unsigned)args[5],
+            (unsigned)args[6], COL_NONE.c_str());
+    return length < 0 ? 0 : static_cast<uint32_t>(length);
+}
+
+/**
+ * @brief Times fn in chunks of half the log ring, flushing the logger between chunks (not timed),
+ * so lines are never dropped. Prints the caller cost and the resulting events/s per core.
+ */
+template<typename F>
+void run_bench_log(const char* name, F fn) {
+    Logger& logger = Logger::get();
+    const int chunk = Logger::RING_SIZE / 2;
+    uint64_t dropped = logger.dropped();
+    uint64_t allocs = alloc_count.load();
+    double elapsed_ns = 0;
+    for (int done = 0; done < iterations; done += chunk) {
+        int count = std::min(chunk, iterations - done);
+        auto ts = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; i++) {
+            fn();
+        }
+        elapsed_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - ts).count();
+        logger.flush();
+    }
+    allocs = alloc_count.load() - allocs;
+    double ns = elapsed_ns / iterations;
+    std::printf("  %-40s %10.1f ns/op %8.2f allocs/op %8.2f M events/s/core", name,
+            ns, allocs / (double)iterations, 1000.0 / ns);
+    if (logger.dropped() != dropped) {
+        std::printf(", %llu dropped", (unsigned long long)(logger.dropped() - dropped));
+    }
+    std::printf("\n");
+}
+
+/**
+ * @brief on_message() debug logging: stringstream line (previous client code) vs deferred formatting.
+ * Log output goes to /dev/null, allocs/op include the log thread.
+ */
+void bench_log() {
+    std::FILE* null_out = std::fopen("/dev/null", "w");
+    if (!null_out) {
+        std::printf("  failed to open /dev/null\n");
+        return;
+    }
+    Logger::get().set_output(null_out, null_out);
+    message_header header = { vsomeip::message_type_e::MT_NOTIFICATION, 0x6000, 0x0001, 0x8005, 0x0000, 0x0001, 12 };
+
+    run_bench_log("on_message header (stringstream only)", [&] {
+        header.session++;
+        std::stringstream its_message;
+        its_message << "[on_message] Received a "
+                << to_string(header.type) << " from Service ["
+                << to_hex(header.service) << "."
+                << to_hex(header.instance) << "."
+                << to_hex(header.method) << "] to Client/Session ["
+                << to_hex(header.client) << "/"
+                << to_hex(header.session)
+                << "] = (" << std::dec << header.length << ") ";
+        do_not_optimize(its_message);
+    });
+    run_bench_log("on_message log (stringstream)", [&] {
+        header.session++;
+        std::stringstream its_message;
+        its_message << "[on_message] Received a "
+                << to_string(header.type) << " from Service ["
+                << to_hex(header.service) << "."
+                << to_hex(header.instance) << "."
+                << to_hex(header.method) << "] to Client/Session ["
+                << to_hex(header.client) << "/"
+                << to_hex(header.session)
+                << "] = (" << std::dec << header.length << ") ";
+        HELLO_LOG(LogLevel::Debug) << COL_YELLOW << its_message.str() << COL_NONE << std::endl;
+    });
+    run_bench_log("on_message log (deferred)", [&] {
+        header.session++;
+        HELLO_LOG_DEFERRED(LogLevel::Debug, format_on_message, header.type, header.service, header.instance,
+                header.method, header.client, header.session, header.length);
+    });
+    char line[Logger::LINE_SIZE];
+    run_bench("format_on_message (log thread)", [&] {
+        header.session++;
+        uint64_t args[] = { (uint64_t)header.type, header.service, header.instance, header.method,
+                header.client, header.session, header.length };
+        do_not_optimize(format_on_message(args, line, sizeof(line)));
+    });
+    Logger::get().flush();
+    Logger::get().set_output(stdout, stderr);
+    std::fclose(null_out);
+}
+
+/**
+ * @brief Measures wakeup jitter (callback time - expected deadline) of a recurring timer.
+ */
+void bench_timer_jitter(TimerBackend backend, int interval_ms) {
+    typedef std::chrono::steady_clock clock;
+    LatencyHistogram jitter;
+    std::mutex mutex;
+    std::condition_variable done;
+    int ticks = 0;
+    uint64_t allocs = 0;
+    clock::time_point start;
+
+    Timer timer(backend);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        start = clock::now();
+        timer.add_timer([&](int) {
+            clock::time_point now = clock::now();
+            std::lock_guard<std::mutex> cb_lock(mutex);
+            if (ticks >= timer_ticks) return;
+            ticks++;
+            if (ticks == 1) allocs = alloc_count.load();
+            clock::time_point deadline = start + std::chrono::milliseconds(interval_ms) * ticks;
+            jitter.record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - deadline).count());
+            if (ticks == timer_ticks) {
+                allocs = alloc_count.load() - allocs;
+                done.notify_one();
+            }
+        }, 1, interval_ms, true);
+        done.wait(lock, [&] { return ticks >= timer_ticks; });
+    }
+    timer.stop_timers();
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "Timer jitter (%s, %d ms)", backend == Backend_TimerFd ? "timerfd" : "cv", interval_ms);
+    std::printf("  %-40s %10.1f us avg, p50: %.1f us, p99: %.1f us, max: %.1f us, %.2f allocs/tick\n", name,
+            jitter.mean() / 1000.0, jitter.percentile(50.0) / 1000.0, jitter.percentile(99.0) / 1000.0,
+            jitter.max() / 1000.0, allocs / (double)timer_ticks);
+}
+
+void bench_timer() {
+    bench_timer_jitter(Backend_CondVar, 1);
+    bench_timer_jitter(Backend_TimerFd, 1);
+    bench_timer_jitter(Backend_CondVar, 10);
+}
+
+static int64_t process_cpu_ns() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief hello_service notify path cost per event, direct vs --batch. vsomeip notify() is replaced by
+ * a no-op, it runs once per event on either path, so the difference is the batching overhead.
+ * Producer: time spent in the notify call (the timer thread), sender: batcher thread CPU incl. wakeups.
+ * @param interval_us producer pause between events (0: back to back)
+ */
+void bench_notify_path(int events, int interval_us) {
+    HelloEvent event = { { 12, 34, 56, 789012345 }, Timer_1ms };
+    std::shared_ptr<vsomeip::payload> payload = vsomeip::runtime::get()->create_payload();
+
+    // per call timing when paced, thread CPU would include the sleeps
+    int64_t producer_ns = 0;
+    auto produce = [&](int i, const std::function<void()>& notify) {
+        event.time_of_day.nanos = i;
+        if (interval_us > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(interval_us));
+            int64_t ts = now_ns();
+            notify();
+            producer_ns += now_ns() - ts;
+        } else {
+            notify();
+        }
+    };
+
+    // notify_direct(): serialize into the timer payload, notify
+    int64_t ts = now_ns();
+    for (int i = 0; i < events; i++) {
+        produce(i, [&] {
+            serialize_hello_event(event, payload);
+            do_not_optimize(payload->get_data()[0]);
+        });
+    }
+    int64_t direct_ns = interval_us > 0 ? producer_ns : now_ns() - ts;
+
+    // post_event(): encode into the batch buffer, sender thread copies into the payload and notifies
+    NotifyBatcher batcher([&payload](uint32_t, const uint8_t* data, uint32_t size) {
+        payload->set_data(data, size);
+        do_not_optimize(payload->get_data()[0]);
+    }, std::chrono::microseconds(1000), 256);
+    batcher.start();
+    producer_ns = 0;
+    ts = now_ns();
+    int64_t process_start = process_cpu_ns();
+    int64_t thread_start = thread_cpu_ns();
+    for (int i = 0; i < events; i++) {
+        produce(i, [&] {
+            batcher.post(0, HELLO_EVENT_PAYLOAD_SIZE, [&](vsomeip::byte_t* dst) {
+                serialize_hello_event(event, dst, HELLO_EVENT_PAYLOAD_SIZE);
+            });
+        });
+    }
+    int64_t post_ns = interval_us > 0 ? producer_ns : now_ns() - ts;
+    batcher.stop();
+    int64_t sender_ns = (process_cpu_ns() - process_start) - (thread_cpu_ns() - thread_start);
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "notify path (%s)", interval_us > 0 ? "paced" : "back to back");
+    std::printf("  %-40s direct: %.1f ns/event, batched: %.1f ns/event (post: %.1f, sender: %.1f)\n",
+            name, direct_ns / (double)events, (post_ns + sender_ns) / (double)events,
+            post_ns / (double)events, sender_ns / (double)events);
+}
+
+void bench_notify() {
+    bench_notify_path(iterations, 0);
+    bench_notify_path(timer_ticks, 100);
+}
+
+struct bench_suite {
+    const char* name;
+    void (*run)();
+};
+
+static const bench_suite BENCH_SUITES[] = {
+    { "event",   bench_serialize_event },
+    { "event",   bench_deserialize_event },
+    { "request", bench_request_codec },
+    { "utils",   bench_event_utils },
+    { "timer",   bench_timer },
+    { "log",     bench_log },
+    { "notify",  bench_notify },
+};
+
+} // namespace HelloExample
+
+int main(int argc, char **argv) {
+    // optional suite names to run, default: all
+    std::vector<std::string> selected(argv + 1, argv + argc);
+    for (const std::string& name : selected) {
+        bool found = false;
+        for (const auto& suite : HelloExample::BENCH_SUITES) {
+            found = found || name == suite.name;
+        }
+        if (!found) {
+            std::printf("Usage: %s [SUITE...]\n  SUITE: event, request, utils, timer, log, notify. Default: all\n"
+                    "ENVIRONMENT:\n  BENCH_ITERATIONS   iterations per benchmark. Default: 1000000\n"
+                    "  BENCH_TIMER_TICKS  expirations per timer benchmark. Default: 2000\n", argv[0]);
+            return 1;
+        }
+    }
+    std::printf("### hello_bench (%d iterations)\n", iterations);
+    for (const auto& suite : HelloExample::BENCH_SUITES) {
+        bool run = selected.empty();
+        for (const std::string& name : selected) {
+            run = run || name == suite.name;
+        }
+        if (run) suite.run();
+    }
+    return 0;
+}
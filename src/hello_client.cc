@@ -10,20 +10,27 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  ********************************************************************************/
+#include <algorithm>
 #include <csignal>
 #include <cmath>
 #include <chrono>
 #include <condition_variable>
+#include <cstdio>
 #include <iomanip>
 #include <iostream>
 #include <string>
 #include <sstream>
 #include <thread>
+#include <vector>
+#include <time.h>
 
 #include <vsomeip/vsomeip.hpp>
 
+#include "hello_log.h"
 #include "hello_proto.h"
+#include "hello_stats.h"
 #include "hello_utils.h"
+#include "mpsc_queue.h"
 
 // suppresses periodic LOG_INFO,LOG_DEBUG,LOG_TRACE messages
 static int quiet = ::getenv("QUIET") ? ::atoi(::getenv("QUIET")) : 0;
@@ -31,6 +38,10 @@ static int quiet = ::getenv("QUIET") ? ::atoi(::getenv("QUIET")) : 0;
 static int debug = ::getenv("DEBUG") ? ::atoi(::getenv("DEBUG")) : 1;
 // delay (ms) after sending a hello request from the request thread
 static int delay = ::getenv("DELAY") ? ::atoi(::getenv("DELAY")) : 0;
+// max time (ms) to wait for a reply before giving up on the remaining requests
+static int reply_timeout = ::getenv("REPLY_TIMEOUT") ? ::atoi(::getenv("REPLY_TIMEOUT")) : 5000;
+// HelloEvents queued from vsomeip dispatcher to the event thread (0=process events on the dispatcher)
+static int event_queue_size = ::getenv("EVENT_QUEUE") ? ::atoi(::getenv("EVENT_QUEUE")) : 4096;
 
 // time difference from previous timer interval to dump warnings for dalay
 static int max_delta = ::getenv("DELTA") ? ::atoi(::getenv("DELTA")) : 0;
@@ -40,16 +51,31 @@ static const std::string P_INFO  = COL_YELLOW + "[HelloCli] " + COL_WHITE_BOLD;
 static const std::string P_DEBUG = COL_YELLOW + "[HelloCli] " + COL_NONE;
 static const std::string P_TRACE = COL_YELLOW + "[HelloCli] " + COL_BLUE;
 
-#define LOG_TRACE  std::cout << P_TRACE
-#define LOG_DEBUG  std::cout << P_DEBUG
-#define LOG_INFO   std::cout << P_INFO
-#define LOG_ERROR  std::cerr << P_ERROR
+// stream-style statements, queued to the async logger (see hello_log.h)
+#define LOG_TRACE  HELLO_LOG(HelloExample::LogLevel::Trace) << P_TRACE
+#define LOG_DEBUG  HELLO_LOG(HelloExample::LogLevel::Debug) << P_DEBUG
+#define LOG_INFO   HELLO_LOG(HelloExample::LogLevel::Info) << P_INFO
+#define LOG_ERROR  HELLO_LOG(HelloExample::LogLevel::Error) << P_ERROR
 
-// terminate log msg (reset colors and flush)
+// terminate log msg (reset colors), the line is queued at the end of the statement
 #define LOG_CR       COL_NONE << std::endl
 
+// captures integer args only, the formatter runs on the log thread (see HELLO_LOG_DEFERRED)
+#define LOG_DEBUG_DEFERRED(formatter, ...) \
+    HELLO_LOG_DEFERRED(HelloExample::LogLevel::Debug, formatter, __VA_ARGS__)
+
 namespace HelloExample {
 
+// on_message() debug line, args: message type, service, instance, method, client, session, payload length
+static uint32_t format_on_message(const uint64_t* args, char* out, uint32_t size) {
+    int length = std::snprintf(out, size,
+            "%s[on_message] Received a %s from Service [%04x.%04x.%04x] to Client/Session [%04x/%04x] = (%u) %s\n",
+            P_DEBUG.c_str(), to_string(static_cast<vsomeip::message_type_e>(args[0])).c_str(),
+            (unsigned)args[1], (unsigned)args[2], (unsigned)args[3], (unsigned)args[4], (unsigned)args[5],
+            (unsigned)args[6], COL_NONE.c_str());
+    return length < 0 ? 0 : static_cast<uint32_t>(length);
+}
+
 class hello_client {
 
 private:
@@ -59,11 +85,15 @@ private:
     bool is_registered_;
     bool is_available_; // HelloService available
     int request_count_; // how many calls to sayHello()
+    int window_; // max requests in flight
 
     HelloRequest hello_req_;
 
     bool blocked_; // is_offered_ must be initialized before starting the threads!
     bool running_;
+    bool events_subscribed_; // prevent double subscribe on reconnect
+    bool print_summary_; // print summaries in stop()
+    std::atomic<bool> stopped_;
 
     std::mutex mutex_;
     std::condition_variable condition_;
@@ -72,34 +102,131 @@ private:
     std::condition_variable request_condition_;
     HelloResponse hello_resp_;
 
-    std::thread request_thread_; // hendles hello request sending loop
-
     // benchmarking
-    std::map<TimerID,int32_t> event_counters_;
-    std::map<TimerID,std::chrono::time_point<std::chrono::high_resolution_clock>> last_event_;
+    // indexed by timer_index(), updated from vsomeip dispatcher threads
+    EventCounter event_counters_[TIMER_COUNT];
     std::chrono::time_point<std::chrono::high_resolution_clock> ts_event_;
+    std::chrono::time_point<std::chrono::high_resolution_clock> ts_stopped_;
+    // HelloEventExt sequence / latency stats per timer, nullptr unless subscribed to HelloEvents
+    std::unique_ptr<EventStreamStats[]> event_stats_;
+
+    // HelloEvent as received by the dispatcher thread, processed by event_thread_
+    struct event_record {
+        HelloEvent event;
+        uint32_t sequence;   // HelloEventExt sequence, 0 for plain HelloEvents
+        uint32_t length;     // payload bytes
+        int64_t latency_ns;  // one-way latency, if has_latency
+        int64_t received_ns; // now_ns() in the dispatcher
+        bool has_latency;
+        bool pattern_error;  // hello_service --size padding mismatch
+    };
+    std::unique_ptr<MpscQueue<event_record>> event_queue_; // nullptr if EVENT_QUEUE=0 or not subscribed
+    std::thread event_thread_; // counts and prints queued HelloEvents
+    std::atomic<bool> event_running_;
+    std::atomic<bool> event_sleeping_;
+    std::mutex event_mutex_;
+    std::condition_variable event_condition_;
+    std::unique_ptr<LatencyHistogram> queue_delay_; // dispatcher -> event thread (ns), with event_queue_
 
     int32_t requests_sent_;
     std::chrono::time_point<std::chrono::high_resolution_clock> ts_req_start_;
     std::chrono::time_point<std::chrono::high_resolution_clock> ts_req_finish_;
-
+    int32_t in_flight_; // guarded by request_mutex_
+    // per request latency, nullptr if requests are disabled (~512 KB, avoid it for --clients N)
+    std::unique_ptr<RequestTracker> request_tracker_;
+    std::string hist_file_; // raw latency histogram dump (optional)
+
+    // load generator events (hello_service --events)
+    struct load_stream {
+        std::atomic<uint64_t> count;
+        GapTracker sequence; // updated from the dispatcher thread
+    };
+    int load_events_;
+    int load_groups_;
+    bool load_subscribed_;
+    std::unique_ptr<load_stream[]> load_streams_;
+    std::atomic<uint64_t> load_bytes_;
+    std::atomic<uint64_t> load_errors_;
+    std::atomic<uint64_t> load_pattern_errors_;
+    std::unique_ptr<LatencyHistogram> load_latency_; // one-way latency (ns) if service sends timestamps
+
+    // hendles hello request sending loop. Declared last: it is started from the constructor
+    // initializer list and run() uses the members above
+    std::thread request_thread_;
 
 public:
-    hello_client(bool _use_tcp, bool _subscribe_events, HelloRequest& _hello_req, int _request_count) :
-        app_(vsomeip::runtime::get()->create_application())
+    hello_client(bool _use_tcp, bool _subscribe_events, HelloRequest& _hello_req, int _request_count, int _window,
+            const std::string& _app_name = "") :
+        app_(vsomeip::runtime::get()->create_application(_app_name))
         , use_tcp_(_use_tcp)
-        , request_count_(_request_count)
-        , hello_req_(_hello_req)
         , subscribe_events_(_subscribe_events)
         , is_registered_(false)
         , is_available_(false)
+        , request_count_(_request_count)
+        , window_(_window)
+        , hello_req_(_hello_req)
         , blocked_(false)
         , running_(true)
-        , event_counters_()
+        , events_subscribed_(false)
+        , print_summary_(true)
+        , stopped_(false)
+        , event_stats_(_subscribe_events ? new EventStreamStats[TIMER_COUNT] : nullptr)
+        , event_running_(true)
+        , event_sleeping_(false)
         , requests_sent_(0)
+        , in_flight_(0)
+        , request_tracker_(_request_count != 0 ? new RequestTracker() : nullptr)
+        , load_events_(0)
+        , load_groups_(1)
+        , load_subscribed_(false)
         , request_thread_(std::bind(&hello_client::run, this))
     {
         pthread_setname_np(request_thread_.native_handle(), "request_thread");
+        if (subscribe_events_ && event_queue_size > 0) {
+            event_queue_.reset(new MpscQueue<event_record>(event_queue_size));
+            queue_delay_.reset(new LatencyHistogram());
+            event_thread_ = std::thread(&hello_client::run_events, this);
+            pthread_setname_np(event_thread_.native_handle(), "event_thread");
+        }
+    }
+
+    ~hello_client() {
+        // normally done by stop(), e.g. not called if init() failed
+        {
+            std::lock_guard<std::mutex> its_lock(mutex_);
+            running_ = false;
+            condition_.notify_one();
+        }
+        request_condition_.notify_one();
+        if (request_thread_.joinable()) {
+            request_thread_.join();
+        }
+        stop_event_thread();
+    }
+
+    void set_histogram_file(const std::string& path) {
+        hist_file_ = path;
+        if (!hist_file_.empty() && !request_tracker_) {
+            // request thread is not sending (request_count_ == 0), safe to allocate here
+            request_tracker_.reset(new RequestTracker());
+        }
+    }
+
+    void set_print_summary(bool enabled) {
+        print_summary_ = enabled;
+    }
+
+    // must be called before init()
+    void set_load_events(int events, int groups) {
+        load_events_ = events;
+        load_groups_ = groups;
+        load_streams_.reset(events > 0 ? new load_stream[events] : nullptr);
+        load_latency_.reset(events > 0 ? new LatencyHistogram() : nullptr);
+    }
+
+    // true if the client keeps running for events after all requests are sent
+    bool has_events() const {
+        return subscribe_events_ || load_events_ > 0;
     }
 
     bool init() {
@@ -114,6 +241,8 @@ public:
                 << "', protocol=" << (use_tcp_ ? "TCP" : "UDP")
                 << ", subscribe_events=" << subscribe_events_
                 << ", req_count=" << request_count_
+                << ", window=" << window_
+                << ", load_events=" << load_events_ << "/" << load_groups_
                 << ", hello='" << hello_req_.message
                 << "', routing=" << app_->is_routing()
                 << "]" << LOG_CR;
@@ -152,15 +281,18 @@ public:
     }
 
     void reset_counters() {
-        event_counters_[Timer_1ms] = 0;
-        event_counters_[Timer_10ms] = 0;
-        event_counters_[Timer_1sec] = 0;
-        event_counters_[Timer_1min] = 0;
-
-        last_event_[Timer_1ms] = {};
-        last_event_[Timer_10ms] = {};
-        last_event_[Timer_1sec] = {};
-        last_event_[Timer_1min] = {};
+        for (int i = 0; i < TIMER_COUNT; i++) {
+            event_counters_[i].reset();
+            if (event_stats_) event_stats_[i].reset();
+        }
+        for (int i = 0; i < load_events_; i++) {
+            load_streams_[i].count = 0;
+            load_streams_[i].sequence.reset();
+        }
+        load_bytes_ = 0;
+        load_errors_ = 0;
+        load_pattern_errors_ = 0;
+        if (load_latency_) load_latency_->reset();
 
         ts_event_ = std::chrono::high_resolution_clock::now();
     }
@@ -172,14 +304,36 @@ public:
 
 
     void print_request_summary() {
-        if (requests_sent_ > 0) {
+        if (requests_sent_ > 0 && request_tracker_) {
             std::chrono::duration<double, std::milli> diff = ts_req_finish_ - ts_req_start_;
+            uint64_t replies = request_tracker_->completed();
             LOG_INFO << LOG_CR;
             LOG_INFO << "### Sent " << requests_sent_ << " Hello requests for "
                     << std::fixed << std::setprecision(4) << diff.count() << " ms. ("
                     << std::fixed << std::setprecision(4)
                     << (requests_sent_ > 0 ? diff.count() / (double)requests_sent_ : 0.0)
-                    << " ms/req)." << LOG_CR;
+                    << " ms/req, window: " << window_ << ")." << LOG_CR;
+            LOG_INFO << "  - Throughput: " << std::fixed << std::setprecision(1)
+                    << (diff.count() > 0 ? replies * 1000.0 / diff.count() : 0.0) << " req/s, replies: "
+                    << replies << "/" << requests_sent_ << LOG_CR;
+            const LatencyHistogram& latency = request_tracker_->latency();
+            LOG_INFO << "  - Latency (ms): avg: " << std::fixed << std::setprecision(4)
+                    << latency.mean() / 1e6
+                    << ", min: " << latency.min() / 1e6
+                    << ", max: " << latency.max() / 1e6 << LOG_CR;
+            LOG_INFO << "  - Latency (ms): p50: " << std::fixed << std::setprecision(4)
+                    << latency.percentile(50.0) / 1e6
+                    << ", p90: " << latency.percentile(90.0) / 1e6
+                    << ", p99: " << latency.percentile(99.0) / 1e6
+                    << ", p99.9: " << latency.percentile(99.9) / 1e6
+                    << ", max: " << latency.max() / 1e6 << LOG_CR;
+            if (!hist_file_.empty()) {
+                if (latency.dump(hist_file_, "SayHello latency (ns), window: " + std::to_string(window_))) {
+                    LOG_INFO << "  - Latency histogram written to: " << hist_file_ << LOG_CR;
+                } else {
+                    LOG_ERROR << "Failed writing latency histogram to: " << hist_file_ << LOG_CR;
+                }
+            }
             LOG_INFO << LOG_CR;
         }
     }
@@ -193,33 +347,125 @@ public:
         LOG_INFO << "### Received HelloEvents (for "
                 << std::fixed << std::setprecision(4) << event_time.count()
                 << " ms)" << LOG_CR;
-        if (event_counters_[Timer_1ms] > 0) {
-            int expected = (int)event_time.count();
-            int percent = expected > 0 ? 100 * event_counters_[Timer_1ms] / expected : 0;
-            LOG_INFO << "  - Event[Timer_1ms]  = " << std::left << std::setw(6) << std::setfill(' ') << event_counters_[Timer_1ms]
+        static const struct {
+            TimerID id;
+            const char* label;
+        } SUMMARY_ORDER[] = {
+            { Timer_1ms,  "  - Event[Timer_1ms]  = " },
+            { Timer_10ms, "  - Event[Timer_10ms] = " },
+            { Timer_1sec, "  - Event[Timer_1sec] = " },
+            { Timer_1min, "  - Event[Timer_1min] = " },
+        };
+        uint64_t total_count = 0;
+        uint64_t total_bytes = 0;
+        for (const auto& item : SUMMARY_ORDER) {
+            const EventCounter& counter = event_counters_[timer_index(item.id)];
+            uint64_t count = counter.count.load(std::memory_order_relaxed);
+            if (count == 0) continue;
+            total_count += count;
+            total_bytes += counter.bytes.load(std::memory_order_relaxed);
+            int expected = (int)(event_time.count() / timer_interval_ms(item.id));
+            int percent = expected > 0 ? (int)(100 * count / expected) : 0;
+            LOG_INFO << item.label << std::left << std::setw(6) << std::setfill(' ') << count
                     << " (expected: " << std::setw(6) << std::setfill(' ') << expected
-                    << " " << std::right << std::setw(3) << std::setfill(' ') << percent << "%)" << LOG_CR;
+                    << " " << std::right << std::setw(3) << std::setfill(' ') << percent << "%)"
+                    << " delta (ms) min: " << std::fixed << std::setprecision(4) << counter.delta_min() / 1e6
+                    << ", max: " << counter.delta_max() / 1e6 << LOG_CR;
         }
-        if (event_counters_[Timer_10ms] > 0) {
-            int expected = event_time.count() / 10;
-            int percent = expected > 0 ? 100 * event_counters_[Timer_10ms] / expected : 0;
-            LOG_INFO << "  - Event[Timer_10ms] = " << std::left << std::setw(6) << std::setfill(' ') << event_counters_[Timer_10ms]
-                    << " (expected: " << std::setw(6) << std::setfill(' ') << expected
-                    << " " << std::right << std::setw(3) << std::setfill(' ') << percent << "%)" << LOG_CR;
+        if (total_count > 0 && event_time.count() > 0) {
+            double seconds = event_time.count() / 1000.0;
+            LOG_INFO << "  - Total: " << total_count << " events, " << std::fixed << std::setprecision(1)
+                    << total_count / seconds << " events/s, " << std::setprecision(3)
+                    << total_bytes / seconds / 1e6 << " MB/s (payload: "
+                    << total_bytes / total_count << " bytes/event)" << LOG_CR;
         }
-        if (event_counters_[Timer_1sec] > 0) {
-            int expected = event_time.count() / 1000;
-            int percent = expected > 0 ? 100 * event_counters_[Timer_1sec] / expected : 0;
-            LOG_INFO << "  - Event[Timer_1sec] = " << std::left << std::setw(6) << std::setfill(' ') << event_counters_[Timer_1sec]
-                    << " (expected: " << std::setw(6) << std::setfill(' ') << expected
-                    << " " << std::right << std::setw(3) << std::setfill(' ') << percent << "%)" << LOG_CR;
+        if (event_queue_) {
+            LOG_INFO << "  - Event queue: capacity: " << event_queue_->capacity()
+                    << ", high-water: " << event_queue_->high_water()
+                    << ", dropped: " << event_queue_->dropped()
+                    << ", delay (ms) p50: " << std::fixed << std::setprecision(4)
+                    << queue_delay_->percentile(50.0) / 1e6
+                    << ", p99: " << queue_delay_->percentile(99.0) / 1e6
+                    << ", max: " << queue_delay_->max() / 1e6 << LOG_CR;
         }
-        if (event_counters_[Timer_1min] > 0) {
-            int expected = event_time.count() / 60000;
-            int percent = expected > 0 ? 100 * event_counters_[Timer_1min] / expected : 0;
-            LOG_INFO << "  - Event[Timer_1min] = " << std::left << std::setw(6) << std::setfill(' ') << event_counters_[Timer_1min]
-                    << " (expected: " << std::setw(6) << std::setfill(' ') << expected
-                    << " " << std::right << std::setw(3) << std::setfill(' ') << percent << "%)" << LOG_CR;
+        // extended events only (hello_service --event-seq / --event-clock)
+        for (int i = 0; i < TIMER_COUNT; i++) {
+            const EventStreamStats& stats = event_stats_[i];
+            const GapTracker& seq = stats.sequence;
+            if (seq.received() == 0) continue;
+            uint64_t expected = seq.received() - seq.duplicates() + seq.lost();
+            LOG_INFO << "  - Event[" << to_string(TIMER_IDS[i]) << "] sequence: received: " << seq.received()
+                    << ", lost: " << seq.lost()
+                    << " (" << std::fixed << std::setprecision(2)
+                    << (expected > 0 ? 100.0 * seq.lost() / expected : 0.0) << "%)"
+                    << ", duplicates: " << seq.duplicates()
+                    << ", out-of-order: " << seq.out_of_order()
+                    << ", gaps: " << seq.gaps()
+                    << ", longest gap: " << seq.longest_gap()
+                    << (seq.restarts() > 0 ? ", restarts: " + std::to_string(seq.restarts()) : "")
+                    << LOG_CR;
+            if (stats.latency.count() > 0) {
+                const LatencyHistogram& latency = stats.latency;
+                LOG_INFO << "    latency (ms): p50: " << std::fixed << std::setprecision(4)
+                        << latency.percentile(50.0) / 1e6
+                        << ", p90: " << latency.percentile(90.0) / 1e6
+                        << ", p99: " << latency.percentile(99.0) / 1e6
+                        << ", p99.9: " << latency.percentile(99.9) / 1e6
+                        << ", max: " << latency.max() / 1e6 << LOG_CR;
+            }
+            if (stats.clock_skew > 0) {
+                LOG_INFO << "    clock skew: " << stats.clock_skew << " events with negative latency!" << LOG_CR;
+            }
+            if (stats.pattern_errors > 0) {
+                LOG_ERROR << "    payload pattern errors: " << stats.pattern_errors << LOG_CR;
+            }
+        }
+        LOG_INFO << LOG_CR;
+    }
+
+    void print_load_summary(const std::chrono::time_point<std::chrono::high_resolution_clock>& ts) {
+        if (load_events_ <= 0) {
+            return;
+        }
+        std::chrono::duration<double> load_time = ts - ts_event_;
+        uint64_t total = 0;
+        uint64_t min_count = std::numeric_limits<uint64_t>::max();
+        uint64_t max_count = 0;
+        uint64_t lost = 0, duplicates = 0, out_of_order = 0;
+        uint32_t longest_gap = 0;
+        int active = 0;
+        for (int i = 0; i < load_events_; i++) {
+            const load_stream& stream = load_streams_[i];
+            uint64_t count = stream.count.load(std::memory_order_relaxed);
+            total += count;
+            min_count = std::min(min_count, count);
+            max_count = std::max(max_count, count);
+            if (count > 0) active++;
+            lost += stream.sequence.lost();
+            duplicates += stream.sequence.duplicates();
+            out_of_order += stream.sequence.out_of_order();
+            longest_gap = std::max(longest_gap, stream.sequence.longest_gap());
+        }
+        LOG_INFO << LOG_CR;
+        LOG_INFO << "### Received load events (for " << std::fixed << std::setprecision(4)
+                << load_time.count() * 1000.0 << " ms)" << LOG_CR;
+        LOG_INFO << "  - Events: " << total << ", " << std::fixed << std::setprecision(1)
+                << (load_time.count() > 0 ? total / load_time.count() : 0.0) << " events/s, "
+                << std::setprecision(3)
+                << (load_time.count() > 0 ? load_bytes_ / load_time.count() / 1e6 : 0.0) << " MB/s"
+                << ", streams: " << active << "/" << load_events_
+                << ", per stream min: " << min_count << ", max: " << max_count << LOG_CR;
+        LOG_INFO << "  - Sequence: lost: " << lost << ", duplicates: " << duplicates
+                << ", out-of-order: " << out_of_order << ", longest gap: " << longest_gap
+                << ", errors: " << load_errors_
+                << ", pattern errors: " << load_pattern_errors_ << LOG_CR;
+        if (load_latency_->count() > 0) {
+            LOG_INFO << "  - Latency (ms): p50: " << std::fixed << std::setprecision(4)
+                    << load_latency_->percentile(50.0) / 1e6
+                    << ", p90: " << load_latency_->percentile(90.0) / 1e6
+                    << ", p99: " << load_latency_->percentile(99.0) / 1e6
+                    << ", p99.9: " << load_latency_->percentile(99.9) / 1e6
+                    << ", max: " << load_latency_->max() / 1e6 << LOG_CR;
         }
         LOG_INFO << LOG_CR;
     }
@@ -228,6 +474,7 @@ public:
      * Handle signal to shutdown
      */
     void stop() {
+        if (stopped_.exchange(true)) return;
         if (debug > 0) LOG_DEBUG << "Stopping..." << LOG_CR;
         running_ = false;
         blocked_ = true;
@@ -235,7 +482,7 @@ public:
         request_condition_.notify_one();
         app_->clear_all_handler();
 
-        auto ts_stopped = std::chrono::high_resolution_clock::now();
+        ts_stopped_ = std::chrono::high_resolution_clock::now();
 
         if (subscribe_events_) {
             // cleanup event service
@@ -243,6 +490,14 @@ public:
             app_->unsubscribe(HELLO_SERVICE_ID, HELLO_INSTANCE_ID, HELLO_EVENTGROUP_ID);
             app_->release_event(HELLO_SERVICE_ID, HELLO_INSTANCE_ID, HELLO_EVENT_ID);
         }
+        if (load_subscribed_) {
+            for (int i = 0; i < load_groups_ && i < load_events_; i++) {
+                app_->unsubscribe(HELLO_SERVICE_ID, HELLO_INSTANCE_ID, HELLO_LOAD_EVENTGROUP_ID + i);
+            }
+            for (int i = 0; i < load_events_; i++) {
+                app_->release_event(HELLO_SERVICE_ID, HELLO_INSTANCE_ID, HELLO_LOAD_EVENT_ID + i);
+            }
+        }
         app_->release_service(HELLO_SERVICE_ID, HELLO_INSTANCE_ID);
         if (std::this_thread::get_id() == request_thread_.get_id()) {
             if (debug > 1) LOG_TRACE << "Detaching request_thread..." << LOG_CR;
@@ -253,16 +508,59 @@ public:
         }
         if (debug > 1) LOG_TRACE << "app->stop()..." << LOG_CR;
         app_->stop();
+        stop_event_thread();
 
         // event benchmarks
-        print_event_summary(ts_stopped);
-        // repeat request summary (could be lost in scrollback)
-        // if (subscribe_events_ && request_count_ > 0)
-        {
+        if (print_summary_) {
+            print_event_summary(ts_stopped_);
+            print_load_summary(ts_stopped_);
+            // repeat request summary (could be lost in scrollback)
             print_request_summary();
         }
     }
 
+    // total timer and load events received
+    uint64_t events_received() const {
+        uint64_t total = 0;
+        for (int i = 0; i < TIMER_COUNT; i++) {
+            total += event_counters_[i].count.load(std::memory_order_relaxed);
+        }
+        for (int i = 0; i < load_events_; i++) {
+            total += load_streams_[i].count.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    // events lost, only known for sequenced events (hello_service --event-seq, --events)
+    uint64_t events_lost() const {
+        uint64_t lost = 0;
+        for (int i = 0; event_stats_ && i < TIMER_COUNT; i++) {
+            lost += event_stats_[i].sequence.lost();
+        }
+        for (int i = 0; i < load_events_; i++) {
+            lost += load_streams_[i].sequence.lost();
+        }
+        return lost;
+    }
+
+    // HelloEvents dropped because the event queue was full
+    uint64_t events_dropped() const {
+        return event_queue_ ? event_queue_->dropped() : 0;
+    }
+
+    // adds one-way event latency of all streams to result (hello_service --event-clock)
+    void merge_event_latency(LatencyHistogram& result) const {
+        for (int i = 0; event_stats_ && i < TIMER_COUNT; i++) {
+            result.merge(event_stats_[i].latency);
+        }
+        if (load_latency_) result.merge(*load_latency_);
+    }
+
+    // seconds from init() to stop()
+    double event_seconds() const {
+        return std::chrono::duration<double>(ts_stopped_ - ts_event_).count();
+    }
+
     void on_state(vsomeip::state_type_e _state) {
         if (_state == vsomeip::state_type_e::ST_REGISTERED) {
             is_registered_ = true;
@@ -311,16 +609,18 @@ public:
                     HELLO_SERVICE_ID, HELLO_INSTANCE_ID, HELLO_EVENT_ID,
                     its_groups, vsomeip::event_type_e::ET_FIELD,
                     (use_tcp_ ? vsomeip::reliability_type_e::RT_RELIABLE : vsomeip::reliability_type_e::RT_UNRELIABLE));
-            static bool subscribed = false; // FIXME: prevent double register on reconnect
-            if (!subscribed) {
+            if (!events_subscribed_) {
                 LOG_DEBUG << "Subscribing EventGroup ["
                         << to_hex(HELLO_SERVICE_ID) << "." << to_hex(HELLO_INSTANCE_ID) << "/"
                         << to_hex(HELLO_EVENTGROUP_ID) << " v" << HELLO_SERVICE_MAJOR
                         << "]" << LOG_CR;
                     app_->subscribe(HELLO_SERVICE_ID, HELLO_INSTANCE_ID, HELLO_EVENTGROUP_ID, HELLO_SERVICE_MAJOR);
-                subscribed = true;
+                events_subscribed_ = true;
             }
         }
+        if (load_events_ > 0 && !load_subscribed_) {
+            subscribe_load_events();
+        }
         // if (request_count_) {
         //     if (send_hello(hello_req_)) {
         //         // Uncomment to prevent multiple hello requests on HelloService reconnection
@@ -329,6 +629,23 @@ public:
         // }
     }
 
+    void subscribe_load_events() {
+        LOG_DEBUG << "Subscribing " << load_events_ << " load events in " << load_groups_ << " eventgroups" << LOG_CR;
+        for (int i = 0; i < load_events_; i++) {
+            std::set<vsomeip::eventgroup_t> its_groups;
+            its_groups.insert(static_cast<vsomeip::eventgroup_t>(HELLO_LOAD_EVENTGROUP_ID + i % load_groups_));
+            app_->request_event(
+                    HELLO_SERVICE_ID, HELLO_INSTANCE_ID, static_cast<vsomeip::event_t>(HELLO_LOAD_EVENT_ID + i),
+                    its_groups, vsomeip::event_type_e::ET_EVENT,
+                    (use_tcp_ ? vsomeip::reliability_type_e::RT_RELIABLE : vsomeip::reliability_type_e::RT_UNRELIABLE));
+        }
+        for (int i = 0; i < load_groups_ && i < load_events_; i++) {
+            app_->subscribe(HELLO_SERVICE_ID, HELLO_INSTANCE_ID,
+                    static_cast<vsomeip::eventgroup_t>(HELLO_LOAD_EVENTGROUP_ID + i), HELLO_SERVICE_MAJOR);
+        }
+        load_subscribed_ = true;
+    }
+
     std::string print_delta(int interval, std::chrono::duration<double, std::milli> delta) {
         if (max_delta == 0) return "";
 
@@ -357,29 +674,119 @@ public:
 
 
     void on_hello_event(const std::shared_ptr<vsomeip::message>& _response) {
-        HelloEvent event;
+        HelloEventExt event_ext;
+        const std::shared_ptr<vsomeip::payload>& payload = _response->get_payload();
         if ((_response->get_return_code() == vsomeip::return_code_e::E_OK) &&
-            deserialize_hello_event(event, _response->get_payload())) {
-            event_counters_[event.timer_id]++;
-            std::string delta_str;
-            if (true) {
-                auto old_ts = last_event_[event.timer_id];
-                auto new_ts = to_time_point(event);
-                last_event_[event.timer_id] = new_ts;
-                std::chrono::duration<double, std::milli> delta = new_ts - old_ts;
-                if (!quiet && old_ts.time_since_epoch().count() > 0) {
-                    delta_str = print_delta(timer_interval_ms(event.timer_id), delta);
-                }
+            deserialize_hello_event(event_ext, payload)) {
+            event_record record;
+            record.event = event_ext.event;
+            record.sequence = event_ext.sequence;
+            record.length = payload->get_length();
+            record.received_ns = now_ns();
+            record.has_latency = event_ext.sequence > 0 && event_ext.clock_id != Clock_None;
+            record.latency_ns = record.has_latency ? clock_now_ns(event_ext.clock_id) - event_ext.timestamp_ns : 0;
+            // hello_service --size padding, payload is valid only in this handler
+            record.pattern_error = event_ext.sequence > 0 && payload->get_length() > HELLO_EVENT_EXT_PAYLOAD_SIZE &&
+                    !check_payload_pattern(payload->get_data(), HELLO_EVENT_EXT_PAYLOAD_SIZE, payload->get_length());
+            if (!event_queue_) {
+                process_event(record);
+            } else if (event_queue_->push(record) && event_sleeping_.load(std::memory_order_seq_cst)) {
+                std::lock_guard<std::mutex> lock(event_mutex_);
+                event_condition_.notify_one();
             }
-            if (!quiet) LOG_INFO << "### " << to_string(event) << delta_str << LOG_CR; // COL_NONE << "\r";
         } else {
             LOG_ERROR << "Failed to parse HelloEvent!" << LOG_CR;
         }
     }
 
+    // updates stats and prints a HelloEvent (event thread, or dispatcher thread if EVENT_QUEUE=0)
+    void process_event(const event_record& record) {
+        const HelloEvent& event = record.event;
+        int index = timer_index(event.timer_id);
+        if (index < 0) {
+            LOG_ERROR << "Invalid HelloEvent TimerID: " << to_int(event.timer_id) << LOG_CR;
+            return;
+        }
+        if (record.sequence > 0 && event_stats_) {
+            event_stats_[index].on_event(record.sequence, record.has_latency, record.latency_ns);
+            if (record.pattern_error) {
+                event_stats_[index].pattern_errors++;
+            }
+        }
+        int64_t event_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                to_time_point(event).time_since_epoch()).count();
+        int64_t delta_ns = event_counters_[index].on_event(event_ns, record.length);
+        if (!quiet) {
+            std::string delta_str;
+            if (delta_ns != EventCounter::NO_DELTA) {
+                delta_str = print_delta(timer_interval_ms(event.timer_id),
+                        std::chrono::duration<double, std::milli>(delta_ns / 1e6));
+            }
+            char event_str[HELLO_EVENT_STR_SIZE];
+            format_hello_event(event, event_str);
+            LOG_INFO << "### " << event_str << delta_str << LOG_CR; // COL_NONE << "\r";
+        }
+    }
+
+    void stop_event_thread() {
+        if (event_thread_.joinable()) {
+            // the event thread processes queued events before exiting
+            {
+                std::lock_guard<std::mutex> lock(event_mutex_);
+                event_running_ = false;
+                event_condition_.notify_one();
+            }
+            event_thread_.join();
+        }
+    }
+
+    void run_events() {
+        event_record record;
+        while (true) {
+            // read before draining, events queued before stop() are still processed
+            bool running = event_running_.load(std::memory_order_acquire);
+            while (event_queue_->pop(record)) {
+                queue_delay_->record(now_ns() - record.received_ns);
+                process_event(record);
+            }
+            if (!running) {
+                break;
+            }
+            std::unique_lock<std::mutex> lock(event_mutex_);
+            event_sleeping_.store(true, std::memory_order_seq_cst);
+            if (event_queue_->empty() && event_running_) {
+                // timeout only guards against a missed wakeup
+                event_condition_.wait_for(lock, std::chrono::milliseconds(10));
+            }
+            event_sleeping_.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    void on_load_event(const std::shared_ptr<vsomeip::message>& _response) {
+        uint32_t index = _response->get_method() - HELLO_LOAD_EVENT_ID;
+        const std::shared_ptr<vsomeip::payload>& payload = _response->get_payload();
+        HelloLoadEvent event;
+        if (!deserialize_hello_load_event(event, payload) || event.stream != index) {
+            load_errors_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (event.clock_id != Clock_None) {
+            int64_t latency = clock_now_ns(event.clock_id) - event.timestamp_ns;
+            if (latency >= 0) load_latency_->record(latency);
+        }
+        if (!check_payload_pattern(payload->get_data(), HELLO_LOAD_HEADER_SIZE, payload->get_length())) {
+            load_pattern_errors_.fetch_add(1, std::memory_order_relaxed);
+        }
+        load_stream& stream = load_streams_[index];
+        stream.count.fetch_add(1, std::memory_order_relaxed);
+        stream.sequence.on_sequence(event.sequence);
+        load_bytes_.fetch_add(payload->get_length(), std::memory_order_relaxed);
+    }
+
     void on_hello_reply(const std::shared_ptr<vsomeip::message>& _response) {
+        if (request_tracker_) request_tracker_->on_reply(_response->get_session(), now_ns());
         std::lock_guard<std::mutex> its_lock(request_mutex_);
-        HelloResponse response;
+        HelloResponseView response = {};
         if (debug > 1) {
             LOG_DEBUG << "[on_hello_reply] ### { "
                     << "RC:" << to_string(_response->get_return_code())
@@ -388,7 +795,7 @@ public:
         }
         if (_response->get_return_code() == vsomeip::return_code_e::E_OK) {
             if (deserialize_hello_response(response, _response->get_payload())) {
-                if (debug > 0) LOG_DEBUG << "### HelloService response: '" << to_string(response) << "'" << LOG_CR;
+                if (debug > 0) LOG_DEBUG << "### HelloService response: '" << response.reply << "'" << LOG_CR;
             } else {
                 LOG_ERROR << "Failed to deserialize HelloResponse payload: ["
                         << bytes_to_string(
@@ -397,29 +804,30 @@ public:
                         << "]" << LOG_CR;
             }
         }
-        hello_resp_ = response;
+        // reuses hello_resp_ string capacity
+        hello_resp_.reply.assign(response.reply.data ? response.reply.data : "", response.reply.size);
+        if (in_flight_ > 0) in_flight_--;
         request_condition_.notify_one();
     }
 
     void on_message(const std::shared_ptr<vsomeip::message>& _response) {
-        std::stringstream its_message;
-
-        its_message << "[on_message] Received a "
-                << to_string(_response->get_message_type()) << " from Service ["
-                << to_hex(_response->get_service()) << "."
-                << to_hex(_response->get_instance()) << "."
-                << to_hex(_response->get_method()) << "] to Client/Session ["
-                << to_hex(_response->get_client()) << "/"
-                << to_hex(_response->get_session())
-                << "] = ";
-        std::shared_ptr<vsomeip::payload> its_payload = _response->get_payload();
-        its_message << "(" << std::dec << its_payload->get_length() << ") ";
-
-        if (debug > 0) {
-            if (debug > 1) {
-                its_message << bytes_to_string(its_payload->get_data(), its_payload->get_length());
-            }
-            LOG_DEBUG << its_message.str() << LOG_CR;
+        if (debug > 1) {
+            // payload dump, formatted in place
+            std::shared_ptr<vsomeip::payload> its_payload = _response->get_payload();
+            LOG_DEBUG << "[on_message] Received a "
+                    << to_string(_response->get_message_type()) << " from Service ["
+                    << to_hex(_response->get_service()) << "."
+                    << to_hex(_response->get_instance()) << "."
+                    << to_hex(_response->get_method()) << "] to Client/Session ["
+                    << to_hex(_response->get_client()) << "/"
+                    << to_hex(_response->get_session())
+                    << "] = (" << std::dec << its_payload->get_length() << ") "
+                    << bytes_to_string(its_payload->get_data(), its_payload->get_length()) << LOG_CR;
+        } else if (debug > 0) {
+            // hot path: only the header fields are queued, format_on_message() runs on the log thread
+            LOG_DEBUG_DEFERRED(format_on_message, _response->get_message_type(),
+                    _response->get_service(), _response->get_instance(), _response->get_method(),
+                    _response->get_client(), _response->get_session(), _response->get_payload()->get_length());
         }
         if (_response->get_return_code() != vsomeip::return_code_e::E_OK) {
             LOG_ERROR << "[on_message] SOME/IP Error: " << to_string(_response->get_return_code()) << LOG_CR;
@@ -429,12 +837,17 @@ public:
         {
             on_hello_event(_response);
         } else
+        if (_response->get_service() == HELLO_SERVICE_ID && _response->get_instance() == HELLO_INSTANCE_ID &&
+            _response->get_method() >= HELLO_LOAD_EVENT_ID && _response->get_method() < HELLO_LOAD_EVENT_ID + load_events_)
+        {
+            on_load_event(_response);
+        } else
         if (_response->get_service() == HELLO_SERVICE_ID && _response->get_instance() == HELLO_INSTANCE_ID &&
             _response->get_method() == HELLO_METHOD_ID)
         {
             on_hello_reply(_response);
 
-            if (!subscribe_events_ && request_count_ == 0) {
+            if (!has_events() && request_count_ == 0) {
     			LOG_INFO << "### Stopping app (no events)." << LOG_CR;
 			    stop();
 		    }
@@ -466,7 +879,10 @@ public:
         HelloRequest req = hello_req_;
         ts_req_start_ = std::chrono::high_resolution_clock::now();
         int hello_sent = 1;
-        while (running_) {
+        if (window_ > 1) {
+            hello_sent = send_pipelined(req);
+        }
+        while (running_ && window_ <= 1) {
             // TODO: wait again if service unavailable?
             if (debug > 0) LOG_DEBUG << "TH: Sending Hello Request ["
                     << hello_sent << "/" << request_count_ << "] "
@@ -488,10 +904,13 @@ public:
         }
         ts_req_finish_ = std::chrono::high_resolution_clock::now();
         requests_sent_ = hello_sent - 1;
+        if (window_ > 1) {
+            wait_replies();
+        }
 
         // print_request_summary();
 
-        if (running_ && !subscribe_events_) {
+        if (running_ && !has_events()) {
             running_ = false;
             LOG_INFO << "All requests have been sent!" << LOG_CR;
             // prevent this thread from joining in stop()
@@ -501,6 +920,49 @@ public:
         if (debug > 1) LOG_TRACE << "TH: // done." << LOG_CR;
     }
 
+    /**
+     * @brief Sends request_count_ requests, keeping up to window_ requests in flight.
+     * @return next request number (as in run())
+     */
+    int send_pipelined(HelloRequest& req) {
+        int hello_sent = 1;
+        while (running_ && hello_sent <= request_count_) {
+            {
+                std::unique_lock<std::mutex> its_lock(request_mutex_);
+                if (!request_condition_.wait_for(its_lock, std::chrono::milliseconds(reply_timeout),
+                        [this] { return !running_ || in_flight_ < window_; })) {
+                    LOG_ERROR << "[send_pipelined] Timeout waiting for replies, in flight: " << in_flight_ << LOG_CR;
+                    break;
+                }
+                if (!running_) break;
+                in_flight_++;
+            }
+            if (request_count_ > 1) {
+                req.message = hello_req_.message + "#" + std::to_string(hello_sent);
+            }
+            if (debug > 1) LOG_TRACE << "TH: Sending Hello Request ["
+                    << hello_sent << "/" << request_count_ << "] " << to_string(req) << " ..." << LOG_CR;
+            send_hello(req, false);
+            hello_sent++;
+            if (running_ && delay > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+            }
+        }
+        return hello_sent;
+    }
+
+    /**
+     * @brief Waits for pending pipelined replies.
+     */
+    void wait_replies() {
+        std::unique_lock<std::mutex> its_lock(request_mutex_);
+        if (!request_condition_.wait_for(its_lock, std::chrono::milliseconds(reply_timeout),
+                [this] { return !running_ || in_flight_ == 0; })) {
+            LOG_ERROR << "[wait_replies] Timeout, missing replies: " << in_flight_ << LOG_CR;
+        }
+        ts_req_finish_ = std::chrono::high_resolution_clock::now();
+    }
+
     HelloResponse send_hello(const HelloRequest& hello_reqest, bool wait_response=false) {
         std::unique_lock<std::mutex> its_lock(request_mutex_);
 
@@ -524,7 +986,10 @@ public:
         // Send the request to the service. Response will be delivered to the
         // registered message handler
         if (debug > 0) LOG_INFO << "### Sending Hello Request: " << to_string(hello_reqest) << LOG_CR;
+        int64_t ts_sent = now_ns();
         app_->send(rq);
+        // session id is assigned by send(), reply may already be received
+        request_tracker_->on_sent(rq->get_session(), ts_sent);
         if (debug > 2) LOG_TRACE << "// Hello Request sent." << LOG_CR;
 
         if (wait_response) {
@@ -538,14 +1003,84 @@ public:
 
 };
 
+/**
+ * @brief Aggregate event delivery of all client applications (--clients N).
+ *
+ * Per client latency percentiles need hello_service --event-clock, notify CPU cost is printed
+ * by hello_service on exit.
+ */
+void print_fanout_summary(const std::vector<std::unique_ptr<hello_client>>& clients, double cpu_seconds) {
+    uint64_t total = 0;
+    uint64_t lost = 0;
+    uint64_t dropped = 0;
+    uint64_t min_count = std::numeric_limits<uint64_t>::max();
+    uint64_t max_count = 0;
+    double seconds = 0;
+    int64_t min_p50 = std::numeric_limits<int64_t>::max(), max_p50 = 0;
+    int64_t min_p99 = std::numeric_limits<int64_t>::max(), max_p99 = 0;
+    std::unique_ptr<LatencyHistogram> latency(new LatencyHistogram());
+    std::unique_ptr<LatencyHistogram> client_latency(new LatencyHistogram());
+    for (const auto& client : clients) {
+        uint64_t count = client->events_received();
+        total += count;
+        lost += client->events_lost();
+        dropped += client->events_dropped();
+        min_count = std::min(min_count, count);
+        max_count = std::max(max_count, count);
+        seconds = std::max(seconds, client->event_seconds());
+
+        client_latency->reset();
+        client->merge_event_latency(*client_latency);
+        if (client_latency->count() > 0) {
+            min_p50 = std::min(min_p50, client_latency->percentile(50.0));
+            max_p50 = std::max(max_p50, client_latency->percentile(50.0));
+            min_p99 = std::min(min_p99, client_latency->percentile(99.0));
+            max_p99 = std::max(max_p99, client_latency->percentile(99.0));
+            latency->merge(*client_latency);
+        }
+    }
+    LOG_INFO << LOG_CR;
+    LOG_INFO << "### Fan-out: " << clients.size() << " clients (for " << std::fixed << std::setprecision(4)
+            << seconds * 1000.0 << " ms)" << LOG_CR;
+    LOG_INFO << "  - Delivered: " << total << " events, " << std::fixed << std::setprecision(1)
+            << (seconds > 0 ? total / seconds : 0.0) << " events/s, per client min: " << min_count
+            << ", avg: " << total / clients.size() << ", max: " << max_count << ", lost: " << lost
+            << ", queue dropped: " << dropped << LOG_CR;
+    if (latency->count() > 0) {
+        LOG_INFO << "  - Latency (ms): p50: " << std::fixed << std::setprecision(4)
+                << latency->percentile(50.0) / 1e6
+                << ", p99: " << latency->percentile(99.0) / 1e6
+                << ", max: " << latency->max() / 1e6 << LOG_CR;
+        LOG_INFO << "  - Client skew (ms): p50: " << std::fixed << std::setprecision(4)
+                << min_p50 / 1e6 << " .. " << max_p50 / 1e6
+                << " (" << (max_p50 - min_p50) / 1e6 << ")"
+                << ", p99: " << min_p99 / 1e6 << " .. " << max_p99 / 1e6
+                << " (" << (max_p99 - min_p99) / 1e6 << ")" << LOG_CR;
+    }
+    if (total > 0) {
+        LOG_INFO << "  - Client process CPU: " << std::fixed << std::setprecision(3)
+                << cpu_seconds << " s, " << cpu_seconds * 1e6 / total << " us/event" << LOG_CR;
+    }
+    LOG_INFO << LOG_CR;
+}
+
 } // namespace HelloExample
 
-static HelloExample::hello_client* hello_client_ptr = NULL;
+static std::vector<std::unique_ptr<HelloExample::hello_client>>* hello_clients_ptr = NULL;
 
 static void handle_signal(int _signal) {
-    if (hello_client_ptr != NULL &&
-            (_signal == SIGINT || _signal == SIGTERM))
-        hello_client_ptr->stop();
+    if (hello_clients_ptr != NULL &&
+            (_signal == SIGINT || _signal == SIGTERM)) {
+        for (auto& client : *hello_clients_ptr) {
+            client->stop();
+        }
+    }
+}
+
+static double process_cpu_seconds() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
 }
 
 void print_help(const char* name) {
@@ -561,12 +1096,23 @@ void print_help(const char* name) {
             << "\n"
             << "  --sub     Subscribe for HelloService events\n"
             << "  --req N   Sends Hello request N times\n"
+            << "  --window N  Keeps up to N Hello requests in flight (pipelined). Default: 1\n"
+            << "  --hist FILE Dumps raw Hello request latency histogram to FILE on exit\n"
+            << "\n"
+            << "  --events N  Subscribe for N hello_service load events (see hello_service --events)\n"
+            << "  --groups M  Load events eventgroup count, must match hello_service --groups. Default: 1\n"
+            << "\n"
+            << "  --clients N Runs N client applications (1..256) in threads, named VSOMEIP_APPLICATION_NAME[_<N>],\n"
+            << "              prints aggregate fan-out summary on exit (implies QUIET=1). Default: 1\n"
             << "\n"
             << "ENVIRONMENT:\n"
             << "  DEBUG           Controls App verbosity (0=info, 1=debug, 2=trace). Default: 1\n"
             << "  QUIET           1=mute all debug/info messages. Default: 0\n"
             << "  DELTA           (benchmark) max delta (ms) from previous timer event. If exceeded dumps Delta warning. Default: 0\n"
             << "  DELAY           ms to wait after sending a SayHello() request (Do not set if benchmarking). Default: 0\n"
+            << "  REPLY_TIMEOUT   ms to wait for pipelined replies (--window). Default: 5000\n"
+            << "  EVENT_QUEUE     HelloEvents queued for the event thread (0=process on vsomeip dispatcher). Default: 4096\n"
+            << "  LOG_SYNC        1=write log lines synchronously instead of the async logger. Default: 0\n"
             << std::endl;
 }
 
@@ -575,7 +1121,9 @@ int main(int argc, char **argv) {
     // default values
     bool use_tcp = false;
     int request_count = 0;
+    int window = 1;
     bool subscribe_events = false;
+    std::string hist_file;
 
     if (quiet == 1) {
         // make sure all debugs are suppressed
@@ -586,7 +1134,16 @@ int main(int argc, char **argv) {
     std::string arg_tcp_enable("--tcp");
     std::string arg_udp_enable("--udp");
     std::string arg_req("--req");
+    std::string arg_window("--window");
     std::string arg_subscribe("--sub");
+    std::string arg_hist("--hist");
+    std::string arg_events("--events");
+    std::string arg_groups("--groups");
+    std::string arg_clients("--clients");
+    int client_count = 1;
+    bool fanout = false; // print fan-out summary
+    int load_events = 0;
+    int load_groups = 1;
 
     int i = 1;
     while (i < argc) {
@@ -601,6 +1158,17 @@ int main(int argc, char **argv) {
                 subscribe_events = true;
             } else if (arg_req == arg && i < argc - 1) {
                 request_count = std::atoi(argv[++i]);
+            } else if (arg_window == arg && i < argc - 1) {
+                window = std::max(1, std::atoi(argv[++i]));
+            } else if (arg_events == arg && i < argc - 1) {
+                load_events = std::min(std::max(0, std::atoi(argv[++i])), HELLO_LOAD_MAX_EVENTS);
+            } else if (arg_groups == arg && i < argc - 1) {
+                load_groups = std::min(std::max(1, std::atoi(argv[++i])), HELLO_LOAD_MAX_GROUPS);
+            } else if (arg_clients == arg && i < argc - 1) {
+                client_count = std::min(std::max(1, std::atoi(argv[++i])), 256);
+                fanout = true;
+            } else if (arg_hist == arg && i < argc - 1) {
+                hist_file = argv[++i];
             } else {
                 print_help(argv[0]);
                 exit(1);
@@ -616,6 +1184,11 @@ int main(int argc, char **argv) {
     if (request_count == 0 && !hello_arg.empty()) {
         request_count = 1;
     }
+    if (client_count > 1) {
+        // per event logs from N clients would dominate the measurement
+        quiet = 1;
+        debug = 0;
+    }
 
     // sanity checks for VSOMEIP environment
     const char* app_name = ::getenv("VSOMEIP_APPLICATION_NAME");
@@ -633,13 +1206,40 @@ int main(int argc, char **argv) {
     if (debug > 1 && request_count) {
         LOG_TRACE << "// [main] Sending request: [" << to_string(req) << "], count:" << request_count << LOG_CR;
     }
-    HelloExample::hello_client client(use_tcp, subscribe_events, req, request_count);
-    hello_client_ptr = &client;
+    // first client uses VSOMEIP_APPLICATION_NAME, others get a "_<N>" suffix
+    std::vector<std::unique_ptr<HelloExample::hello_client>> hello_clients;
+    for (int n = 0; n < client_count; n++) {
+        std::string name = n == 0 ? app_name : std::string(app_name) + "_" + std::to_string(n);
+        HelloExample::hello_client* client =
+                new HelloExample::hello_client(use_tcp, subscribe_events, req, request_count, window, name);
+        client->set_histogram_file(hist_file);
+        client->set_load_events(load_events, load_groups);
+        client->set_print_summary(client_count == 1);
+        hello_clients.emplace_back(client);
+    }
+    hello_clients_ptr = &hello_clients;
     signal(SIGINT, handle_signal);
     signal(SIGTERM, handle_signal);
 
-    if (!client.init()) {
-        exit(1);
+    for (auto& client : hello_clients) {
+        if (!client->init()) {
+            // clients join their threads when destroyed
+            hello_clients_ptr = NULL;
+            return 1;
+        }
+    }
+    double cpu_start = process_cpu_seconds();
+    std::vector<std::thread> threads;
+    for (int n = 1; n < client_count; n++) {
+        HelloExample::hello_client* client = hello_clients[n].get();
+        threads.emplace_back([client] { client->start(); });
+    }
+    hello_clients[0]->start();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (fanout) {
+        HelloExample::print_fanout_summary(hello_clients, process_cpu_seconds() - cpu_start);
     }
-    client.start();
+    hello_clients_ptr = NULL;
 }
@@ -0,0 +1,478 @@
+/*
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <stdint.h>
+#include <vsomeip/vsomeip.hpp>
+#include "hello_proto.h"
+
+/**
+ * Compile-time generated SOME/IP (big endian) codec for HelloExample messages.
+ *
+ * Message fields are declared once with fields_of<Msg> specializations (see bottom of this file),
+ * codec<Msg, Layout> then provides wire size, encode and bounds checked decode.
+ * Messages with fixed size fields only (e.g. HelloEvent) are encoded/decoded with compile-time
+ * field offsets and a single bounds check.
+ */
+namespace HelloExample {
+namespace codec {
+
+typedef vsomeip::byte_t byte_t;
+
+// Wire layout policies (only strings differ)
+
+// Strings are raw "\0" terminated bytes, taking the rest of the payload (uservice compatible)
+struct PlainLayout {};
+// [TR_SOMEIP_00091] Strings with dynamic length start with a uint32 length field (including "\0")
+struct AutosarLayout {};
+
+#ifdef AUTOSAR_WIRE
+typedef AutosarLayout DefaultLayout;
+#else
+typedef PlainLayout DefaultLayout;
+#endif
+
+// Per message layout, specialize to use a different layout for a specific message type
+template<typename Msg>
+struct layout_of {
+    typedef DefaultLayout type;
+};
+
+// Wire type for enums, defaults to the underlying type
+template<typename E>
+struct enum_wire {
+    typedef typename std::underlying_type<E>::type type;
+};
+
+// Field declarations
+
+template<typename Class, typename T, T Class::*Member>
+struct field {
+    typedef T type;
+    static const T& get(const Class& obj) { return obj.*Member; }
+    static T& get(Class& obj) { return obj.*Member; }
+};
+
+template<typename... Fields>
+struct field_list {};
+
+#define HELLO_FIELD(Class, member) \
+    ::HelloExample::codec::field<Class, decltype(Class::member), &Class::member>
+
+// Specialize with: typedef field_list<HELLO_FIELD(Msg, a), HELLO_FIELD(Msg, b), ...> type;
+template<typename Msg>
+struct fields_of;
+
+// Big endian load/store
+
+inline uint8_t to_big_endian(uint8_t value) { return value; }
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+inline uint16_t to_big_endian(uint16_t value) { return __builtin_bswap16(value); }
+inline uint32_t to_big_endian(uint32_t value) { return __builtin_bswap32(value); }
+inline uint64_t to_big_endian(uint64_t value) { return __builtin_bswap64(value); }
+#else
+inline uint16_t to_big_endian(uint16_t value) { return value; }
+inline uint32_t to_big_endian(uint32_t value) { return value; }
+inline uint64_t to_big_endian(uint64_t value) { return value; }
+#endif
+
+template<typename T>
+inline void store_be(byte_t* dst, T value) {
+    typedef typename std::make_unsigned<T>::type U;
+    U be = to_big_endian(static_cast<U>(value));
+    std::memcpy(dst, &be, sizeof(be));
+}
+
+template<typename T>
+inline T load_be(const byte_t* src) {
+    typedef typename std::make_unsigned<T>::type U;
+    U be;
+    std::memcpy(&be, src, sizeof(be));
+    return static_cast<T>(to_big_endian(be));
+}
+
+/**
+ * codec<T, Layout> interface:
+ *   is_fixed, fixed_size        - compile-time wire size (fixed_size is 0 for dynamic types)
+ *   size(value)                 - wire size of value
+ *   encode(value, dst)          - writes size(value) bytes, returns end of written data
+ *   decode(value, src, length)  - returns consumed bytes or -1 if src is too short / malformed
+ * fixed size codecs also provide encode_fixed(value, dst) and decode_fixed(value, src) without checks.
+ */
+template<typename T, typename Layout, typename Enable = void>
+struct codec;
+
+template<typename T, typename Layout>
+struct fixed_codec_base {
+    static uint32_t size(const T&) { return T_size(); }
+    static byte_t* encode(const T& value, byte_t* dst) {
+        codec<T, Layout>::encode_fixed(value, dst);
+        return dst + T_size();
+    }
+    static int32_t decode(T& value, const byte_t* src, uint32_t length) {
+        if (length < T_size()) return -1;
+        codec<T, Layout>::decode_fixed(value, src);
+        return static_cast<int32_t>(T_size());
+    }
+private:
+    static constexpr uint32_t T_size() { return codec<T, Layout>::fixed_size; }
+};
+
+// integers
+template<typename T, typename Layout>
+struct codec<T, Layout, typename std::enable_if<std::is_integral<T>::value>::type>
+        : fixed_codec_base<T, Layout> {
+    static constexpr bool is_fixed = true;
+    static constexpr uint32_t fixed_size = sizeof(T);
+    static void encode_fixed(const T& value, byte_t* dst) { store_be<T>(dst, value); }
+    static void decode_fixed(T& value, const byte_t* src) { value = load_be<T>(src); }
+};
+
+// enums, encoded as enum_wire<E>::type
+template<typename E, typename Layout>
+struct codec<E, Layout, typename std::enable_if<std::is_enum<E>::value>::type>
+        : fixed_codec_base<E, Layout> {
+    typedef typename enum_wire<E>::type wire_type;
+    static constexpr bool is_fixed = true;
+    static constexpr uint32_t fixed_size = sizeof(wire_type);
+    static void encode_fixed(const E& value, byte_t* dst) { store_be<wire_type>(dst, static_cast<wire_type>(value)); }
+    static void decode_fixed(E& value, const byte_t* src) { value = static_cast<E>(load_be<wire_type>(src)); }
+};
+
+// string wire format per layout
+template<typename Layout>
+struct string_wire;
+
+// PlainLayout: must be the last field of a message
+template<>
+struct string_wire<PlainLayout> {
+    static constexpr uint32_t header_size = 0;
+    static void write_header(byte_t*, uint32_t) {}
+    // returns consumed bytes or -1, str_size includes '\0'
+    static int32_t read(const byte_t*, uint32_t length, uint32_t& str_size) {
+        if (length == 0) return -1;
+        str_size = length;
+        return static_cast<int32_t>(length);
+    }
+};
+
+template<>
+struct string_wire<AutosarLayout> {
+    static constexpr uint32_t header_size = 4;
+    static void write_header(byte_t* dst, uint32_t str_size) { store_be<uint32_t>(dst, str_size); }
+    static int32_t read(const byte_t* src, uint32_t length, uint32_t& str_size) {
+        if (length < header_size) return -1;
+        str_size = load_be<uint32_t>(src);
+        if (str_size == 0 || str_size > length - header_size) return -1;
+        return static_cast<int32_t>(header_size + str_size);
+    }
+};
+
+// strings ("\0" terminated on the wire)
+template<typename Layout>
+struct codec<std::string, Layout> {
+    typedef string_wire<Layout> wire;
+    static constexpr bool is_fixed = false;
+    static constexpr uint32_t fixed_size = 0;
+    static uint32_t size(const std::string& value) { return wire::header_size + value.size() + 1; }
+    static byte_t* encode(const std::string& value, byte_t* dst) {
+        wire::write_header(dst, value.size() + 1);
+        dst += wire::header_size;
+        std::memcpy(dst, value.data(), value.size());
+        dst[value.size()] = 0u; // add terminator char: '\x0'
+        return dst + value.size() + 1;
+    }
+    static int32_t decode(std::string& value, const byte_t* src, uint32_t length) {
+        uint32_t str_size = 0;
+        int32_t consumed = wire::read(src, length, str_size);
+        if (consumed < 0) return -1;
+        // skip the ending '\0'
+        value.assign(reinterpret_cast<const char*>(src) + wire::header_size, str_size - 1);
+        return consumed;
+    }
+};
+
+// string views, decoding borrows from src
+template<typename Layout>
+struct codec<StringView, Layout> {
+    typedef string_wire<Layout> wire;
+    static constexpr bool is_fixed = false;
+    static constexpr uint32_t fixed_size = 0;
+    static uint32_t size(const StringView& value) { return wire::header_size + value.size + 1; }
+    static byte_t* encode(const StringView& value, byte_t* dst) {
+        wire::write_header(dst, value.size + 1);
+        dst += wire::header_size;
+        std::memcpy(dst, value.data, value.size);
+        dst[value.size] = 0u;
+        return dst + value.size + 1;
+    }
+    static int32_t decode(StringView& value, const byte_t* src, uint32_t length) {
+        uint32_t str_size = 0;
+        int32_t consumed = wire::read(src, length, str_size);
+        if (consumed < 0) return -1;
+        value.data = reinterpret_cast<const char*>(src) + wire::header_size;
+        value.size = str_size - 1;
+        return consumed;
+    }
+};
+
+// message fields, Offset is the compile-time offset of the first field (valid while all fields are fixed)
+template<typename Layout, uint32_t Offset, typename... Fields>
+struct fields_codec;
+
+template<typename Layout, uint32_t Offset>
+struct fields_codec<Layout, Offset> {
+    static constexpr bool is_fixed = true;
+    static constexpr uint32_t fixed_size = 0;
+    template<typename C> static uint32_t size(const C&) { return 0; }
+    template<typename C> static void encode_fixed(const C&, byte_t*) {}
+    template<typename C> static void decode_fixed(C&, const byte_t*) {}
+    template<typename C> static byte_t* encode(const C&, byte_t* dst) { return dst; }
+    template<typename C> static int32_t decode(C&, const byte_t*, uint32_t) { return 0; }
+};
+
+template<typename Layout, uint32_t Offset, typename F, typename... Rest>
+struct fields_codec<Layout, Offset, F, Rest...> {
+    typedef codec<typename F::type, Layout> head;
+    typedef fields_codec<Layout, Offset + head::fixed_size, Rest...> tail;
+
+    static constexpr bool is_fixed = head::is_fixed && tail::is_fixed;
+    static constexpr uint32_t fixed_size = head::fixed_size + tail::fixed_size;
+
+    template<typename C> static uint32_t size(const C& msg) {
+        return head::size(F::get(msg)) + tail::size(msg);
+    }
+    template<typename C> static void encode_fixed(const C& msg, byte_t* dst) {
+        head::encode_fixed(F::get(msg), dst + Offset);
+        tail::encode_fixed(msg, dst);
+    }
+    template<typename C> static void decode_fixed(C& msg, const byte_t* src) {
+        head::decode_fixed(F::get(msg), src + Offset);
+        tail::decode_fixed(msg, src);
+    }
+    template<typename C> static byte_t* encode(const C& msg, byte_t* dst) {
+        return tail::encode(msg, head::encode(F::get(msg), dst));
+    }
+    template<typename C> static int32_t decode(C& msg, const byte_t* src, uint32_t length) {
+        int32_t consumed = head::decode(F::get(msg), src, length);
+        if (consumed < 0) return -1;
+        int32_t rest = tail::decode(msg, src + consumed, length - consumed);
+        return rest < 0 ? -1 : consumed + rest;
+    }
+};
+
+template<typename Layout, typename List>
+struct make_fields_codec;
+
+template<typename Layout, typename... Fields>
+struct make_fields_codec<Layout, field_list<Fields...>> {
+    typedef fields_codec<Layout, 0, Fields...> type;
+};
+
+// messages (anything else with a fields_of<> specialization)
+template<typename Msg, typename Layout, typename Enable>
+struct codec {
+    typedef typename make_fields_codec<Layout, typename fields_of<Msg>::type>::type impl;
+    typedef std::integral_constant<bool, impl::is_fixed> fixed_tag;
+
+    static constexpr bool is_fixed = impl::is_fixed;
+    static constexpr uint32_t fixed_size = impl::fixed_size;
+
+    static uint32_t size(const Msg& msg) {
+        if (is_fixed) return fixed_size;
+        return impl::size(msg);
+    }
+    static void encode_fixed(const Msg& msg, byte_t* dst) { impl::encode_fixed(msg, dst); }
+    static void decode_fixed(Msg& msg, const byte_t* src) { impl::decode_fixed(msg, src); }
+    static byte_t* encode(const Msg& msg, byte_t* dst) { return encode(msg, dst, fixed_tag()); }
+    static int32_t decode(Msg& msg, const byte_t* src, uint32_t length) { return decode(msg, src, length, fixed_tag()); }
+
+private:
+    static byte_t* encode(const Msg& msg, byte_t* dst, std::true_type) {
+        impl::encode_fixed(msg, dst);
+        return dst + fixed_size;
+    }
+    static byte_t* encode(const Msg& msg, byte_t* dst, std::false_type) {
+        return impl::encode(msg, dst);
+    }
+    static int32_t decode(Msg& msg, const byte_t* src, uint32_t length, std::true_type) {
+        if (length < fixed_size) return -1; // single bounds check
+        impl::decode_fixed(msg, src);
+        return static_cast<int32_t>(fixed_size);
+    }
+    static int32_t decode(Msg& msg, const byte_t* src, uint32_t length, std::false_type) {
+        return impl::decode(msg, src, length);
+    }
+};
+
+// Convenience functions
+
+template<typename Msg, typename Layout = typename layout_of<Msg>::type>
+uint32_t wire_size(const Msg& msg) {
+    return codec<Msg, Layout>::size(msg);
+}
+
+/**
+ * @brief Encodes msg in a caller provided buffer.
+ * @return encoded size, or 0 if buffer is too small.
+ */
+template<typename Msg, typename Layout = typename layout_of<Msg>::type>
+uint32_t encode(const Msg& msg, byte_t* buffer, uint32_t size) {
+    uint32_t msg_size = codec<Msg, Layout>::size(msg);
+    if (size < msg_size) return 0;
+    codec<Msg, Layout>::encode(msg, buffer);
+    return msg_size;
+}
+
+/**
+ * @brief Encodes msg in the payload, reusing payload buffer if its length matches.
+ */
+template<typename Msg, typename Layout = typename layout_of<Msg>::type>
+bool encode(const Msg& msg, const std::shared_ptr<vsomeip::payload>& payload) {
+    uint32_t msg_size = codec<Msg, Layout>::size(msg);
+    if (payload->get_length() == msg_size) {
+        codec<Msg, Layout>::encode(msg, payload->get_data());
+        return true;
+    }
+    // per thread scratch buffer, only allocates when a bigger message is encoded
+    static thread_local std::vector<byte_t> buffer;
+    if (buffer.size() < msg_size) buffer.resize(msg_size);
+    codec<Msg, Layout>::encode(msg, buffer.data());
+    payload->set_data(buffer.data(), msg_size);
+    return true;
+}
+
+/**
+ * @brief Decodes msg from data, trailing bytes are ignored.
+ */
+template<typename Msg, typename Layout = typename layout_of<Msg>::type>
+bool decode(Msg& msg, const byte_t* data, uint32_t length) {
+    return codec<Msg, Layout>::decode(msg, data, length) >= 0;
+}
+
+template<typename Msg, typename Layout = typename layout_of<Msg>::type>
+bool decode(Msg& msg, const std::shared_ptr<vsomeip::payload>& payload) {
+    return decode<Msg, Layout>(msg, payload->get_data(), payload->get_length());
+}
+
+//
+// HelloExample message definitions
+//
+
+// TimerID is sent as a single byte
+template<>
+struct enum_wire<TimerID> {
+    typedef uint8_t type;
+};
+
+template<>
+struct enum_wire<EventClock> {
+    typedef uint8_t type;
+};
+
+template<>
+struct fields_of<HelloRequest> {
+    typedef field_list<
+        HELLO_FIELD(HelloRequest, message)
+    > type;
+};
+
+template<>
+struct fields_of<HelloResponse> {
+    typedef field_list<
+        HELLO_FIELD(HelloResponse, reply)
+    > type;
+};
+
+template<>
+struct fields_of<HelloRequestView> {
+    typedef field_list<
+        HELLO_FIELD(HelloRequestView, message)
+    > type;
+};
+
+template<>
+struct fields_of<HelloResponseView> {
+    typedef field_list<
+        HELLO_FIELD(HelloResponseView, reply)
+    > type;
+};
+
+// views share the wire layout with the owning messages
+template<>
+struct layout_of<HelloRequestView> : layout_of<HelloRequest> {};
+
+template<>
+struct layout_of<HelloResponseView> : layout_of<HelloResponse> {};
+
+template<>
+struct fields_of<TimeOfDay> {
+    typedef field_list<
+        HELLO_FIELD(TimeOfDay, hours),
+        HELLO_FIELD(TimeOfDay, minutes),
+        HELLO_FIELD(TimeOfDay, seconds),
+        HELLO_FIELD(TimeOfDay, nanos)
+    > type;
+};
+
+template<>
+struct fields_of<HelloEvent> {
+    typedef field_list<
+        HELLO_FIELD(HelloEvent, time_of_day),
+        HELLO_FIELD(HelloEvent, timer_id)
+    > type;
+};
+
+template<>
+struct fields_of<HelloEventExt> {
+    typedef field_list<
+        HELLO_FIELD(HelloEventExt, event),
+        HELLO_FIELD(HelloEventExt, sequence),
+        HELLO_FIELD(HelloEventExt, clock_id),
+        HELLO_FIELD(HelloEventExt, timestamp_ns)
+    > type;
+};
+
+template<>
+struct fields_of<HelloLoadEvent> {
+    typedef field_list<
+        HELLO_FIELD(HelloLoadEvent, stream),
+        HELLO_FIELD(HelloLoadEvent, sequence),
+        HELLO_FIELD(HelloLoadEvent, clock_id),
+        HELLO_FIELD(HelloLoadEvent, timestamp_ns)
+    > type;
+};
+
+static_assert(codec<HelloEvent, DefaultLayout>::is_fixed &&
+              codec<HelloEvent, DefaultLayout>::fixed_size == HELLO_EVENT_PAYLOAD_SIZE,
+              "HelloEvent wire format mismatch");
+static_assert(codec<HelloEventExt, DefaultLayout>::is_fixed &&
+              codec<HelloEventExt, DefaultLayout>::fixed_size == HELLO_EVENT_EXT_PAYLOAD_SIZE,
+              "HelloEventExt wire format mismatch");
+static_assert(codec<HelloLoadEvent, DefaultLayout>::is_fixed &&
+              codec<HelloLoadEvent, DefaultLayout>::fixed_size == HELLO_LOAD_HEADER_SIZE,
+              "HelloLoadEvent wire format mismatch");
+
+} // namespace codec
+} // namespace HelloExample
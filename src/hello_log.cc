@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <pthread.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "hello_log.h"
+
+namespace HelloExample {
+
+constexpr uint32_t Logger::LINE_SIZE;
+constexpr uint32_t Logger::RING_SIZE;
+constexpr uint32_t Logger::MAX_ARGS;
+
+// drain thread write batch, flushed when full or when switching between stdout / stderr
+static constexpr size_t BATCH_SIZE = 64 * 1024;
+// drain thread poll interval, waking it up for each line would cost a futex call per line
+static constexpr std::chrono::milliseconds DRAIN_INTERVAL(10);
+
+Logger& Logger::get() {
+    // never destroyed: other threads may still log during static destruction
+    static Logger* instance = [] {
+        Logger* logger = new Logger();
+        std::atexit([] { Logger::get().stop(); });
+        return logger;
+    }();
+    return *instance;
+}
+
+Logger::Logger() :
+        ring_(RING_SIZE), batch_(new char[BATCH_SIZE]), written_(0), truncated_(0),
+        reported_drops_(0), sleeping_(false), running_(true),
+        sync_(::getenv("LOG_SYNC") && ::atoi(::getenv("LOG_SYNC")) != 0), out_(stdout), err_(stderr) {
+    if (sync_) {
+        running_ = false;
+    } else {
+        thread_ = std::thread(&Logger::drain_th, this);
+        pthread_setname_np(thread_.native_handle(), "hello_log");
+    }
+}
+
+void Logger::write(LogLevel level, const char* text, uint32_t length) {
+    std::FILE* out = level == LogLevel::Error ? err_ : out_;
+    std::fwrite(text, 1, length, out);
+    std::fflush(out);
+}
+
+Logger::line* Logger::claim(uint64_t& pos) {
+    // nullptr if full, drain thread is RING_SIZE lines behind
+    return ring_.claim(pos);
+}
+
+void Logger::publish(uint64_t pos) {
+    ring_.publish(pos);
+
+    // the drain thread polls each DRAIN_INTERVAL, wake it up early only if the ring fills up
+    if (pos - written_.load(std::memory_order_relaxed) >= RING_SIZE / 2 &&
+            sleeping_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        condition_.notify_one();
+    }
+}
+
+bool Logger::push(LogLevel level, const char* text, uint32_t length) {
+    if (!running_.load(std::memory_order_acquire)) {
+        write(level, text, length);
+        return true;
+    }
+    uint64_t pos;
+    line* cell = claim(pos);
+    if (!cell) return false;
+    cell->level = level;
+    cell->formatter = nullptr;
+    cell->length = length < LINE_SIZE ? length : LINE_SIZE;
+    std::memcpy(cell->text, text, cell->length);
+    publish(pos);
+    return true;
+}
+
+bool Logger::push_args(LogLevel level, log_formatter formatter, const uint64_t* args, uint32_t count) {
+    if (!running_.load(std::memory_order_acquire)) {
+        char text[LINE_SIZE];
+        write(level, text, format(formatter, args, text));
+        return true;
+    }
+    uint64_t pos;
+    line* cell = claim(pos);
+    if (!cell) return false;
+    cell->level = level;
+    cell->formatter = formatter;
+    cell->length = count < MAX_ARGS ? count : MAX_ARGS;
+    std::memcpy(cell->args, args, cell->length * sizeof(uint64_t));
+    publish(pos);
+    return true;
+}
+
+uint32_t Logger::format(log_formatter formatter, const uint64_t* args, char* out) {
+    uint32_t length = formatter(args, out, LINE_SIZE);
+    if (length >= LINE_SIZE) {
+        // formatter output was cut (snprintf returns the full length), same marker as LogLine
+        on_truncated();
+        static const char MARKER[] = "...\n";
+        std::memcpy(out + LINE_SIZE - (sizeof(MARKER) - 1), MARKER, sizeof(MARKER) - 1);
+        length = LINE_SIZE;
+    }
+    return length;
+}
+
+uint32_t Logger::drain() {
+    char* batch = batch_.get();
+    size_t batch_length = 0;
+    std::FILE* batch_out = out_;
+    uint32_t count = 0;
+
+    uint64_t drops = ring_.dropped();
+    if (drops != reported_drops_) {
+        char text[64];
+        int length = std::snprintf(text, sizeof(text), "[log] dropped %llu lines\n",
+                (unsigned long long)(drops - reported_drops_));
+        std::fwrite(text, 1, length, err_);
+        reported_drops_ = drops;
+    }
+    while (const line* next = ring_.front()) {
+        const line& cell = *next;
+        std::FILE* out = cell.level == LogLevel::Error ? err_ : out_;
+        if (out != batch_out || batch_length + LINE_SIZE > BATCH_SIZE) {
+            std::fwrite(batch, 1, batch_length, batch_out);
+            batch_length = 0;
+            batch_out = out;
+        }
+        if (cell.formatter) {
+            // deferred line, format straight into the batch
+            batch_length += format(cell.formatter, cell.args, batch + batch_length);
+        } else {
+            std::memcpy(batch + batch_length, cell.text, cell.length);
+            batch_length += cell.length;
+        }
+
+        ring_.release();
+        count++;
+    }
+    if (batch_length > 0) {
+        std::fwrite(batch, 1, batch_length, batch_out);
+    }
+    if (count > 0) {
+        written_.fetch_add(count, std::memory_order_release);
+    }
+    return count;
+}
+
+void Logger::drain_th() {
+    while (true) {
+        if (drain() > 0) {
+            continue;
+        }
+        // flush also lines printed directly (printf) from other threads
+        std::fflush(out_);
+        std::fflush(err_);
+        if (!running_.load(std::memory_order_acquire)) {
+            break;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        sleeping_.store(true, std::memory_order_seq_cst);
+        if (!ring_.front() && running_) {
+            condition_.wait_for(lock, DRAIN_INTERVAL);
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+    drain();
+    std::fflush(out_);
+    std::fflush(err_);
+}
+
+void Logger::flush() {
+    uint64_t target = ring_.pushed();
+    while (running_.load(std::memory_order_acquire) && written_.load(std::memory_order_acquire) < target) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            condition_.notify_one();
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    std::fflush(out_);
+}
+
+void Logger::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        condition_.notify_one();
+    }
+    if (thread_.joinable() && std::this_thread::get_id() != thread_.get_id()) {
+        thread_.join();
+    }
+}
+
+void log_flush() {
+    Logger::get().flush();
+}
+
+LogLine::LogLine(LogLevel level) : level_(level), owned_(false) {
+    static thread_local formatter local;
+    if (local.in_use) {
+        // log statement while formatting another one on this thread
+        formatter_ = new formatter();
+        owned_ = true;
+    } else {
+        formatter_ = &local;
+    }
+    formatter_->in_use = true;
+    formatter_->buffer.reset();
+    stream_ = &formatter_->stream;
+    // no sticky formatting between lines
+    stream_->clear();
+    stream_->flags(std::ios_base::dec | std::ios_base::skipws);
+    stream_->precision(6);
+    stream_->fill(' ');
+    stream_->width(0);
+}
+
+LogLine::~LogLine() {
+    Logger& logger = Logger::get();
+    LogLineBuffer& buffer = formatter_->buffer;
+    if (buffer.truncated()) {
+        logger.on_truncated();
+        static const char MARKER[] = "...\n";
+        std::memcpy(const_cast<char*>(buffer.data()) + buffer.length() - (sizeof(MARKER) - 1),
+                MARKER, sizeof(MARKER) - 1);
+    }
+    logger.push(level_, buffer.data(), buffer.length());
+    formatter_->in_use = false;
+    if (owned_) {
+        delete formatter_;
+    }
+}
+
+} // namespace HelloExample
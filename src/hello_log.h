@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <thread>
+
+#include <stdint.h>
+
+#include "mpsc_queue.h"
+
+// Compile-time log level, statements above it are compiled out (see LOG_* macros in hello_*.cc)
+#define HELLO_LOG_LEVEL_ERROR 0
+#define HELLO_LOG_LEVEL_INFO  1
+#define HELLO_LOG_LEVEL_DEBUG 2
+#define HELLO_LOG_LEVEL_TRACE 3
+
+#ifndef HELLO_LOG_LEVEL
+#define HELLO_LOG_LEVEL HELLO_LOG_LEVEL_TRACE
+#endif
+
+// Starts a stream-style log statement, e.g. HELLO_LOG(LogLevel::Info) << "x: " << x << std::endl;
+// The line is queued when the statement ends. Levels above HELLO_LOG_LEVEL are elided by the compiler.
+#define HELLO_LOG(level) \
+    ((int)(level) > HELLO_LOG_LEVEL) ? (void)0 : HelloExample::LogVoidify() & HelloExample::LogLine(level)
+
+// Queues the raw integer arguments only, formatter runs later on the drain thread, e.g.
+// HELLO_LOG_DEFERRED(LogLevel::Debug, format_request, service, method, length);
+// Arguments must be integers / enums, they are captured as uint64_t.
+#define HELLO_LOG_DEFERRED(level, formatter, ...) \
+    ((int)(level) > HELLO_LOG_LEVEL) ? (void)0 : \
+    (void)HelloExample::Logger::get().push_deferred(level, formatter, __VA_ARGS__)
+
+namespace HelloExample {
+
+enum class LogLevel : int {
+    Error = HELLO_LOG_LEVEL_ERROR,
+    Info  = HELLO_LOG_LEVEL_INFO,
+    Debug = HELLO_LOG_LEVEL_DEBUG,
+    Trace = HELLO_LOG_LEVEL_TRACE
+};
+
+/**
+ * @brief Formats the arguments of a deferred log statement into out (size bytes), returns the line
+ * length like snprintf (>= size if cut). Runs on the drain thread (or the caller with LOG_SYNC=1).
+ */
+typedef uint32_t (*log_formatter)(const uint64_t* args, char* out, uint32_t size);
+
+/**
+ * @brief Asynchronous logger: producers copy formatted lines into a bounded lock-free MPSC ring
+ * (MpscQueue, written in place), a background thread writes them to stdout (stderr for errors) in batches.
+ *
+ * If the ring is full the line is dropped and counted, the drain thread reports drops inline.
+ * Lines longer than LINE_SIZE are truncated. LOG_SYNC=1 disables the ring (direct writes).
+ * Deferred lines (push_deferred) carry up to MAX_ARGS integers and are formatted by the drain thread.
+ */
+class Logger {
+public:
+    static constexpr uint32_t LINE_SIZE = 480;
+    static constexpr uint32_t RING_SIZE = 1024; // power of 2
+    static constexpr uint32_t MAX_ARGS = LINE_SIZE / sizeof(uint64_t);
+
+    // process wide instance, never destroyed (drained at exit)
+    static Logger& get();
+
+    // queues a line, returns false if dropped
+    bool push(LogLevel level, const char* text, uint32_t length);
+    // queues a line formatted later by formatter(args), returns false if dropped
+    bool push_args(LogLevel level, log_formatter formatter, const uint64_t* args, uint32_t count);
+    // push_args() with integer / enum arguments
+    template<typename... Args>
+    bool push_deferred(LogLevel level, log_formatter formatter, Args... args) {
+        static_assert(sizeof...(Args) <= MAX_ARGS, "too many deferred log arguments");
+        const uint64_t values[] = { static_cast<uint64_t>(args)... };
+        return push_args(level, formatter, values, sizeof...(Args));
+    }
+    // blocks until all lines pushed before the call are written
+    void flush();
+    // drains pending lines and stops the drain thread, later lines are written synchronously
+    void stop();
+    // redirects output (default stdout / stderr), pending lines may go to either, flush() first
+    void set_output(std::FILE* out, std::FILE* err) { out_ = out; err_ = err; }
+
+    uint64_t dropped() const { return ring_.dropped(); }
+    uint64_t truncated() const { return truncated_.load(std::memory_order_relaxed); }
+    void on_truncated() { truncated_.fetch_add(1, std::memory_order_relaxed); }
+
+private:
+    struct line {
+        LogLevel level;
+        uint32_t length;          // text length, argument count for deferred lines
+        log_formatter formatter;  // nullptr for preformatted lines
+        union {
+            char text[LINE_SIZE];
+            uint64_t args[MAX_ARGS];
+        };
+    };
+
+    Logger();
+
+    void write(LogLevel level, const char* text, uint32_t length);
+    // claims the next ring line, nullptr if full (counted as dropped)
+    line* claim(uint64_t& pos);
+    void publish(uint64_t pos);
+    // runs a deferred line formatter into out (LINE_SIZE bytes), returns the line length
+    uint32_t format(log_formatter formatter, const uint64_t* args, char* out);
+    void drain_th();
+    // writes available lines, returns the number of lines written
+    uint32_t drain();
+
+    MpscQueue<line> ring_;
+    std::unique_ptr<char[]> batch_; // drain thread write buffer
+    std::atomic<uint64_t> written_; // lines consumed, for flush() and ring fill level
+    std::atomic<uint64_t> truncated_;
+    uint64_t reported_drops_;
+
+    std::atomic<bool> sleeping_;
+    std::atomic<bool> running_;
+    bool sync_;
+    std::atomic<std::FILE*> out_;
+    std::atomic<std::FILE*> err_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::thread thread_;
+};
+
+// flushes pending log lines, e.g. before writing to stdout directly (printf)
+void log_flush();
+
+/**
+ * @brief Fixed size, allocation-free stream buffer holding one log line.
+ */
+class LogLineBuffer : public std::streambuf {
+public:
+    LogLineBuffer() { reset(); }
+
+    void reset() { setp(data_, data_ + Logger::LINE_SIZE); truncated_ = false; }
+    const char* data() const { return pbase(); }
+    uint32_t length() const { return static_cast<uint32_t>(pptr() - pbase()); }
+    bool truncated() const { return truncated_; }
+
+protected:
+    int_type overflow(int_type ch) override {
+        truncated_ = true;
+        return traits_type::not_eof(ch);
+    }
+
+private:
+    char data_[Logger::LINE_SIZE];
+    bool truncated_;
+};
+
+/**
+ * @brief One log statement. Formats into a per-thread buffer with the usual ostream operators and
+ * manipulators (state is reset for each line), queues the line to Logger in the destructor.
+ */
+class LogLine {
+public:
+    explicit LogLine(LogLevel level);
+    ~LogLine();
+
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+
+    template<typename T>
+    LogLine& operator<<(const T& value) {
+        *stream_ << value;
+        return *this;
+    }
+
+    // manipulators, e.g. std::endl, std::fixed
+    LogLine& operator<<(std::ostream& (*manip)(std::ostream&)) {
+        manip(*stream_);
+        return *this;
+    }
+
+    LogLine& operator<<(std::ios_base& (*manip)(std::ios_base&)) {
+        manip(*stream_);
+        return *this;
+    }
+
+private:
+    struct formatter {
+        LogLineBuffer buffer;
+        std::ostream stream;
+        bool in_use;
+        formatter() : stream(&buffer), in_use(false) {}
+    };
+
+    LogLevel level_;
+    formatter* formatter_;
+    bool owned_; // nested log statement, formatter_ is not the thread local one
+    std::ostream* stream_;
+};
+
+// lets HELLO_LOG() be an expression (no dangling else), & binds weaker than <<
+struct LogVoidify {
+    void operator&(const LogLine&) {}
+};
+
+} // namespace HelloExample
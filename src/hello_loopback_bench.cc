@@ -0,0 +1,647 @@
+/*
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <pthread.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <vsomeip/vsomeip.hpp>
+
+#include "hello_proto.h"
+#include "hello_stats.h"
+#include "hello_utils.h"
+#include "timer.h"
+
+static int debug = ::getenv("DEBUG") ? ::atoi(::getenv("DEBUG")) : 0;
+
+static const std::string P_ERROR = COL_GREEN + "[Loopback] " + COL_RED;
+static const std::string P_INFO  = COL_GREEN + "[Loopback] " + COL_WHITE_BOLD;
+
+// stdout is reserved for CSV output
+#define LOG_INFO   std::cerr << P_INFO
+#define LOG_ERROR  std::cerr << P_ERROR
+// terminate log msg (reset colors and flush)
+#define LOG_CR       COL_NONE << std::endl
+
+namespace HelloExample {
+
+static const char* ROUTING_NAME = "hello_loopback_routing";
+static const char* SERVICE_NAME = "hello_loopback_service";
+static const char* CLIENT_NAME  = "hello_loopback_client";
+
+static const vsomeip::client_t ROUTING_ID = 0x1100;
+static const vsomeip::client_t SERVICE_ID = 0x1101;
+static const vsomeip::client_t CLIENT_ID  = 0x1110;
+
+/**
+ * @brief Writes a local-only vsomeip configuration: routing host, service and N clients in one process,
+ * service discovery disabled, so all traffic uses the local (UDS) routing path.
+ */
+bool write_config(const std::string& path, int clients) {
+    std::ofstream out(path);
+    out << "{\n"
+        << "  \"unicast\": \"127.0.0.1\",\n"
+        << "  \"network\": \"hello-loopback-" << ::getpid() << "\",\n"
+        << "  \"logging\": {\n"
+        << "    \"level\": \"" << (debug > 0 ? "debug" : "warning") << "\",\n"
+        << "    \"console\": \"" << (debug > 0 ? "true" : "false") << "\",\n"
+        << "    \"file\": { \"enable\": \"false\" },\n"
+        << "    \"dlt\": \"false\"\n"
+        << "  },\n"
+        << "  \"applications\": [\n"
+        << "    { \"name\": \"" << ROUTING_NAME << "\", \"id\": \"0x" << to_hex(ROUTING_ID) << "\" },\n"
+        << "    { \"name\": \"" << SERVICE_NAME << "\", \"id\": \"0x" << to_hex(SERVICE_ID) << "\" }";
+    for (int i = 0; i < clients; i++) {
+        out << ",\n    { \"name\": \"" << CLIENT_NAME << "_" << i
+            << "\", \"id\": \"0x" << to_hex(CLIENT_ID + i) << "\" }";
+    }
+    out << "\n  ],\n"
+        << "  \"routing\": \"" << ROUTING_NAME << "\",\n"
+        << "  \"service-discovery\": { \"enable\": \"false\" }\n"
+        << "}\n";
+    return out.good();
+}
+
+/**
+ * @brief Runs app->start() in a named thread, waits until the application is registered.
+ */
+class app_runner {
+public:
+    app_runner(const std::string& name) :
+        app_(vsomeip::runtime::get()->create_application(name)), registered_(false) {
+    }
+
+    ~app_runner() {
+        stop();
+    }
+
+    const std::shared_ptr<vsomeip::application>& app() const { return app_; }
+
+    // call after registering all handlers
+    bool start(std::chrono::milliseconds timeout) {
+        app_->register_state_handler([this](vsomeip::state_type_e state) {
+            std::lock_guard<std::mutex> its_lock(mutex_);
+            registered_ = (state == vsomeip::state_type_e::ST_REGISTERED);
+            condition_.notify_all();
+        });
+        thread_ = std::thread([this] { app_->start(); });
+        pthread_setname_np(thread_.native_handle(), app_->get_name().substr(0, 15).c_str());
+        std::unique_lock<std::mutex> its_lock(mutex_);
+        return condition_.wait_for(its_lock, timeout, [this] { return registered_; });
+    }
+
+    void stop() {
+        if (thread_.joinable()) {
+            app_->stop();
+            thread_.join();
+        }
+    }
+
+private:
+    std::shared_ptr<vsomeip::application> app_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool registered_;
+};
+
+/**
+ * @brief Minimal HelloService: answers SayHello() and sends load events paced at a configurable rate.
+ *
+ * Not the hello_service implementation (notify batcher, ServiceStats, timers are not used), together
+ * with loopback_client it measures vsomeip routing and the Hello codec only.
+ */
+class loopback_service {
+public:
+    loopback_service(uint32_t event_size) :
+        runner_(SERVICE_NAME), rate_(0), running_(true), idle_(true), sent_(0), sequence_(0) {
+        payload_ = vsomeip::runtime::get()->create_payload();
+        std::vector<vsomeip::byte_t> data(std::max(event_size, (uint32_t)HELLO_LOAD_HEADER_SIZE));
+        fill_payload_pattern(data.data(), HELLO_LOAD_HEADER_SIZE, static_cast<uint32_t>(data.size()));
+        payload_->set_data(data);
+    }
+
+    ~loopback_service() {
+        stop();
+    }
+
+    bool init() {
+        const std::shared_ptr<vsomeip::application>& app = runner_.app();
+        if (!app->init()) return false;
+        app->register_message_handler(HELLO_SERVICE_ID, HELLO_INSTANCE_ID, HELLO_METHOD_ID,
+                std::bind(&loopback_service::on_message, this, std::placeholders::_1));
+        std::set<vsomeip::eventgroup_t> groups = { HELLO_LOAD_EVENTGROUP_ID };
+        app->offer_event(HELLO_SERVICE_ID, HELLO_INSTANCE_ID, HELLO_LOAD_EVENT_ID, groups,
+                vsomeip::event_type_e::ET_EVENT, std::chrono::milliseconds::zero(),
+                false, true, nullptr, vsomeip::reliability_type_e::RT_UNRELIABLE);
+        app->offer_service(HELLO_SERVICE_ID, HELLO_INSTANCE_ID, HELLO_SERVICE_MAJOR, HELLO_SERVICE_MINOR);
+        return true;
+    }
+
+    bool start() {
+        if (!runner_.start(std::chrono::seconds(5))) return false;
+        notify_thread_ = std::thread(std::bind(&loopback_service::notify_th, this));
+        pthread_setname_np(notify_thread_.native_handle(), "notify_thread");
+        return true;
+    }
+
+    void stop() {
+        if (notify_thread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> its_lock(mutex_);
+                running_ = false;
+                condition_.notify_all();
+            }
+            notify_thread_.join();
+            runner_.app()->stop_offer_service(HELLO_SERVICE_ID, HELLO_INSTANCE_ID,
+                    HELLO_SERVICE_MAJOR, HELLO_SERVICE_MINOR);
+        }
+        runner_.stop();
+    }
+
+    // events/s, 0 stops sending events and returns when the last event was sent
+    void set_rate(double rate) {
+        std::unique_lock<std::mutex> its_lock(mutex_);
+        rate_ = rate;
+        condition_.notify_all();
+        if (rate <= 0) {
+            condition_.wait(its_lock, [this] { return idle_ || !running_ || !notify_thread_.joinable(); });
+        }
+    }
+
+    uint64_t sent() const { return sent_; }
+    void reset() { sent_ = 0; }
+
+private:
+    void on_message(const std::shared_ptr<vsomeip::message>& request) {
+        static thread_local std::shared_ptr<vsomeip::payload> resp_payload = vsomeip::runtime::get()->create_payload();
+        static const StringView HELLO_PREFIX = { "Hello ", 6 };
+
+        std::shared_ptr<vsomeip::message> response = vsomeip::runtime::get()->create_response(request);
+        HelloRequestView hello_request;
+        if (!deserialize_hello_request(hello_request, request->get_payload())) {
+            LOG_ERROR << "[on_message] Failed to deserialize request payload!" << LOG_CR;
+        }
+        serialize_hello_response(HELLO_PREFIX, hello_request.message, resp_payload);
+        response->set_payload(resp_payload);
+        runner_.app()->send(response);
+    }
+
+    void notify_th() {
+        typedef TokenBucket::clock clock;
+        HelloLoadEvent header = { 0, 0, Clock_Monotonic, 0 };
+        while (true) {
+            double rate;
+            {
+                std::unique_lock<std::mutex> its_lock(mutex_);
+                idle_ = !(rate_ > 0);
+                condition_.notify_all();
+                condition_.wait(its_lock, [this] { return !running_ || rate_ > 0; });
+                if (!running_) break;
+                idle_ = false;
+                rate = rate_;
+            }
+            TokenBucket bucket(rate, std::max(1.0, rate / 1000.0));
+            bucket.reset(clock::now());
+            // restart pacing when set_rate() changes the rate
+            while (running_ && rate_ == rate) {
+                clock::time_point ready;
+                if (!bucket.try_acquire(clock::now(), ready)) {
+                    TokenBucket::wait_until(ready);
+                    continue;
+                }
+                header.sequence = ++sequence_;
+                header.timestamp_ns = clock_now_ns(Clock_Monotonic);
+                serialize_hello_load_event(header, payload_);
+                runner_.app()->notify(HELLO_SERVICE_ID, HELLO_INSTANCE_ID, HELLO_LOAD_EVENT_ID, payload_);
+                sent_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    app_runner runner_;
+    std::shared_ptr<vsomeip::payload> payload_;
+    std::thread notify_thread_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::atomic<double> rate_;
+    std::atomic<bool> running_;
+    bool idle_; // notify thread is not sending, guarded by mutex_
+    std::atomic<uint64_t> sent_;
+    uint32_t sequence_;
+};
+
+/**
+ * @brief Minimal HelloClient: keeps up to `window` SayHello() requests in flight and receives load events.
+ */
+class loopback_client {
+public:
+    loopback_client(int index) :
+        runner_(std::string(CLIENT_NAME) + "_" + std::to_string(index)),
+        available_(false), window_(0), in_flight_(0), running_(true), events_(0), event_errors_(0) {
+        request_ = { "loopback_" + std::to_string(index) };
+        payload_ = vsomeip::runtime::get()->create_payload();
+        serialize_hello_request(request_, payload_);
+    }
+
+    ~loopback_client() {
+        stop();
+    }
+
+    bool init() {
+        const std::shared_ptr<vsomeip::application>& app = runner_.app();
+        if (!app->init()) return false;
+        app->register_message_handler(HELLO_SERVICE_ID, HELLO_INSTANCE_ID, vsomeip::ANY_METHOD,
+                std::bind(&loopback_client::on_message, this, std::placeholders::_1));
+        app->register_availability_handler(HELLO_SERVICE_ID, HELLO_INSTANCE_ID,
+                [this](vsomeip::service_t, vsomeip::instance_t, bool available) {
+                    std::lock_guard<std::mutex> its_lock(mutex_);
+                    available_ = available;
+                    condition_.notify_all();
+                });
+        app->request_service(HELLO_SERVICE_ID, HELLO_INSTANCE_ID, HELLO_SERVICE_MAJOR, HELLO_SERVICE_MINOR);
+        std::set<vsomeip::eventgroup_t> groups = { HELLO_LOAD_EVENTGROUP_ID };
+        app->request_event(HELLO_SERVICE_ID, HELLO_INSTANCE_ID, HELLO_LOAD_EVENT_ID, groups,
+                vsomeip::event_type_e::ET_EVENT, vsomeip::reliability_type_e::RT_UNRELIABLE);
+        app->subscribe(HELLO_SERVICE_ID, HELLO_INSTANCE_ID, HELLO_LOAD_EVENTGROUP_ID, HELLO_SERVICE_MAJOR);
+        return true;
+    }
+
+    bool start() {
+        if (!runner_.start(std::chrono::seconds(5))) return false;
+        request_thread_ = std::thread(std::bind(&loopback_client::request_th, this));
+        pthread_setname_np(request_thread_.native_handle(), "request_thread");
+        return true;
+    }
+
+    void stop() {
+        if (request_thread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> its_lock(mutex_);
+                running_ = false;
+                condition_.notify_all();
+            }
+            request_thread_.join();
+        }
+        runner_.stop();
+    }
+
+    bool wait_available(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> its_lock(mutex_);
+        return condition_.wait_for(its_lock, timeout, [this] { return available_; });
+    }
+
+    // starts sending requests with up to window in flight, 0 stops sending
+    void set_window(int window) {
+        std::lock_guard<std::mutex> its_lock(mutex_);
+        window_ = window;
+        condition_.notify_all();
+    }
+
+    // waits for in flight requests after set_window(0)
+    bool wait_replies(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> its_lock(mutex_);
+        return condition_.wait_for(its_lock, timeout, [this] { return in_flight_ == 0; });
+    }
+
+    // waits until count events were received (or failed to parse), lost events end in a timeout
+    bool wait_events(uint64_t count, std::chrono::milliseconds timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (events_ + event_errors_ < count) {
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    // stats are written by the dispatcher thread without locking, call only when drained:
+    // no requests in flight (wait_replies()) and no events pending (wait_events())
+    void reset() {
+        requests_.reset();
+        sequence_.reset();
+        event_latency_.reset();
+        events_ = 0;
+        event_errors_ = 0;
+    }
+
+    const RequestTracker& requests() const { return requests_; }
+    const GapTracker& sequence() const { return sequence_; }
+    const LatencyHistogram& event_latency() const { return event_latency_; }
+    uint64_t events() const { return events_; }
+    uint64_t event_errors() const { return event_errors_; }
+
+private:
+    void request_th() {
+        const std::shared_ptr<vsomeip::application>& app = runner_.app();
+        std::unique_lock<std::mutex> its_lock(mutex_);
+        while (running_) {
+            condition_.wait(its_lock, [this] {
+                return !running_ || (available_ && in_flight_ < window_);
+            });
+            if (!running_) break;
+            in_flight_++;
+            its_lock.unlock();
+
+            std::shared_ptr<vsomeip::message> request = vsomeip::runtime::get()->create_request(false);
+            request->set_service(HELLO_SERVICE_ID);
+            request->set_instance(HELLO_INSTANCE_ID);
+            request->set_method(HELLO_METHOD_ID);
+            request->set_payload(payload_);
+            int64_t ts_sent = now_ns();
+            app->send(request);
+            // session id is assigned by send(), reply may already be received
+            requests_.on_sent(request->get_session(), ts_sent);
+
+            its_lock.lock();
+        }
+    }
+
+    void on_message(const std::shared_ptr<vsomeip::message>& message) {
+        int64_t ts = now_ns();
+        if (message->get_message_type() == vsomeip::message_type_e::MT_NOTIFICATION) {
+            HelloLoadEvent event;
+            if (!deserialize_hello_load_event(event, message->get_payload())) {
+                event_errors_++;
+                return;
+            }
+            // single dispatcher thread per application, GapTracker needs no locking
+            sequence_.on_sequence(event.sequence);
+            event_latency_.record(clock_now_ns(Clock_Monotonic) - event.timestamp_ns);
+            events_.fetch_add(1, std::memory_order_relaxed);
+        } else if (message->get_message_type() == vsomeip::message_type_e::MT_RESPONSE) {
+            requests_.on_reply(message->get_session(), ts);
+            std::lock_guard<std::mutex> its_lock(mutex_);
+            in_flight_--;
+            condition_.notify_all();
+        }
+    }
+
+    app_runner runner_;
+    HelloRequest request_;
+    std::shared_ptr<vsomeip::payload> payload_;
+    std::thread request_thread_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool available_;
+    int window_;
+    int in_flight_;
+    bool running_;
+
+    RequestTracker requests_;
+    GapTracker sequence_;
+    LatencyHistogram event_latency_;
+    std::atomic<uint64_t> events_;
+    std::atomic<uint64_t> event_errors_;
+};
+
+struct sweep_config {
+    int clients;
+    std::vector<int> windows;
+    std::vector<double> rates;
+    std::chrono::milliseconds duration;
+    uint32_t event_size;
+};
+
+void print_csv_header(std::ostream& out) {
+    out << "clients,window,rate,size,duration_s"
+        << ",requests,req_per_s,req_avg_us,req_p50_us,req_p99_us,req_max_us"
+        << ",events_sent,events_received,events_lost,events_per_s,event_avg_us,event_p50_us,event_p99_us,event_max_us"
+        << std::endl;
+}
+
+/**
+ * @brief Stops requests and events, waits until clients got all replies and events sent so far.
+ * Afterwards the client dispatcher threads are idle and the stats can be reset.
+ */
+void drain(loopback_service& service, std::vector<std::unique_ptr<loopback_client>>& clients) {
+    for (auto& client : clients) client->set_window(0);
+    service.set_rate(0);
+    for (auto& client : clients) {
+        if (!client->wait_replies(std::chrono::seconds(5))) {
+            LOG_ERROR << "Timeout waiting for replies" << LOG_CR;
+        }
+    }
+    // events never received are reported as lost
+    for (auto& client : clients) {
+        client->wait_events(service.sent(), std::chrono::milliseconds(500));
+    }
+}
+
+/**
+ * @brief Runs one sweep step: requests with `window` in flight per client and events at `rate` for
+ * `duration`, then drains and writes a CSV row with values aggregated over all clients.
+ */
+void run_step(loopback_service& service, std::vector<std::unique_ptr<loopback_client>>& clients,
+        const sweep_config& config, int window, double rate, std::ostream& out) {
+    // previous step (or warm up) was drained, dispatcher threads are idle
+    service.reset();
+    for (auto& client : clients) client->reset();
+
+    auto start = std::chrono::steady_clock::now();
+    service.set_rate(rate);
+    for (auto& client : clients) client->set_window(window);
+    std::this_thread::sleep_for(config.duration);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    drain(service, clients);
+
+    // per client histograms are merged by weighting, percentiles are the worst client
+    uint64_t requests = 0, received = 0, lost = 0, event_count = 0;
+    double req_sum = 0, event_sum = 0;
+    int64_t req_p50 = 0, req_p99 = 0, req_max = 0, event_p50 = 0, event_p99 = 0, event_max = 0;
+    for (auto& client : clients) {
+        const LatencyHistogram& req = client->requests().latency();
+        requests += req.count();
+        req_sum += req.mean() * req.count();
+        req_p50 = std::max(req_p50, req.percentile(50.0));
+        req_p99 = std::max(req_p99, req.percentile(99.0));
+        req_max = std::max(req_max, req.max());
+
+        const LatencyHistogram& ev = client->event_latency();
+        event_count += ev.count();
+        event_sum += ev.mean() * ev.count();
+        event_p50 = std::max(event_p50, ev.percentile(50.0));
+        event_p99 = std::max(event_p99, ev.percentile(99.0));
+        event_max = std::max(event_max, ev.max());
+
+        received += client->events();
+        // events sent but never seen by this client
+        lost += service.sent() > client->events() ? service.sent() - client->events() : 0;
+    }
+
+    char row[512];
+    std::snprintf(row, sizeof(row),
+            "%d,%d,%.0f,%u,%.3f,%llu,%.1f,%.2f,%.2f,%.2f,%.2f,%llu,%llu,%llu,%.1f,%.2f,%.2f,%.2f,%.2f",
+            config.clients, window, rate, config.event_size, seconds,
+            (unsigned long long)requests, requests / seconds,
+            requests ? req_sum / requests / 1e3 : 0.0, req_p50 / 1e3, req_p99 / 1e3, req_max / 1e3,
+            (unsigned long long)service.sent(), (unsigned long long)received, (unsigned long long)lost,
+            received / seconds,
+            event_count ? event_sum / event_count / 1e3 : 0.0, event_p50 / 1e3, event_p99 / 1e3, event_max / 1e3);
+    out << row << std::endl;
+}
+
+} // namespace HelloExample
+
+template <typename T>
+static bool parse_list(const std::string& text, double (*parse)(const std::string&), std::vector<T>& result) {
+    std::stringstream ss(text);
+    std::string item;
+    result.clear();
+    while (std::getline(ss, item, ',')) {
+        double value = parse(item);
+        if (value < 0) return false;
+        result.push_back(static_cast<T>(value));
+    }
+    return !result.empty();
+}
+
+void print_help(const char* name) {
+    std::cout
+            << "Usage: " << name << " {OPTIONS}\n"
+            << "\n"
+            << "Runs vsomeip routing, a HelloService and N HelloClients in one process (local UDS routing,\n"
+            << "no network) and sweeps request windows x event rates, printing one CSV row per step.\n"
+            << "Service and clients are minimal copies: measures vsomeip routing and the Hello codec, not\n"
+            << "the hello_service / hello_client implementations.\n"
+            << "\n"
+            << "OPTIONS:\n"
+            << "  --clients N       Number of client applications. Default: 1\n"
+            << "  --windows LIST    Comma separated request windows per client (0=no requests). Default: 1,8,32\n"
+            << "  --rates LIST      Comma separated event rates, events/s with k/M suffix (0=no events). Default: 0,1k,10k\n"
+            << "  --duration TIME   Duration of each step (us, ms, s). Default: 2s\n"
+            << "  --size BYTES      Event payload size, min " << HelloExample::HELLO_LOAD_HEADER_SIZE << ". Default: "
+            << HelloExample::HELLO_LOAD_HEADER_SIZE << "\n"
+            << "  --csv FILE        Write CSV to FILE instead of stdout\n"
+            << "\n"
+            << "ENVIRONMENT:\n"
+            << "  DEBUG           1=enable vsomeip console logging. Default: 0\n"
+            << std::endl;
+}
+
+int main(int argc, char **argv) {
+    HelloExample::sweep_config config = {
+        1, { 1, 8, 32 }, { 0, 1000, 10000 }, std::chrono::seconds(2), HelloExample::HELLO_LOAD_HEADER_SIZE
+    };
+    std::string csv_file;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool ok = i + 1 < argc;
+        if (ok && arg == "--clients") {
+            config.clients = std::atoi(argv[++i]);
+            ok = config.clients > 0 && config.clients <= 0xEF;
+        } else if (ok && arg == "--windows") {
+            ok = parse_list(argv[++i], HelloExample::parse_rate, config.windows);
+        } else if (ok && arg == "--rates") {
+            ok = parse_list(argv[++i], HelloExample::parse_rate, config.rates);
+        } else if (ok && arg == "--duration") {
+            int64_t duration_us = HelloExample::parse_duration_us(argv[++i]);
+            config.duration = std::chrono::milliseconds(duration_us / 1000);
+            ok = config.duration.count() > 0;
+        } else if (ok && arg == "--size") {
+            config.event_size = static_cast<uint32_t>(std::atoi(argv[++i]));
+            ok = config.event_size >= HelloExample::HELLO_LOAD_HEADER_SIZE && config.event_size <= 65536;
+        } else if (ok && arg == "--csv") {
+            csv_file = argv[++i];
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            LOG_ERROR << "Invalid argument: " << arg << LOG_CR;
+            print_help(argv[0]);
+            return 1;
+        }
+    }
+
+    // all applications in this process share the generated configuration
+    std::string config_file = "/tmp/hello_loopback_" + std::to_string(::getpid()) + ".json";
+    if (!HelloExample::write_config(config_file, config.clients)) {
+        LOG_ERROR << "Failed writing " << config_file << LOG_CR;
+        return 1;
+    }
+    ::setenv("VSOMEIP_CONFIGURATION", config_file.c_str(), 1);
+
+    std::ofstream csv;
+    if (!csv_file.empty()) {
+        csv.open(csv_file);
+    }
+    std::ostream& out = csv_file.empty() ? std::cout : csv;
+
+    int result = 1;
+    {
+        // routing host must be up before other applications register
+        HelloExample::app_runner routing(HelloExample::ROUTING_NAME);
+        HelloExample::loopback_service service(config.event_size);
+        std::vector<std::unique_ptr<HelloExample::loopback_client>> clients;
+        for (int i = 0; i < config.clients; i++) {
+            clients.emplace_back(new HelloExample::loopback_client(i));
+        }
+
+        bool ok = routing.app()->init() && routing.start(std::chrono::seconds(5));
+        ok = ok && service.init() && service.start();
+        for (auto& client : clients) {
+            ok = ok && client->init() && client->start() && client->wait_available(std::chrono::seconds(5));
+        }
+        if (ok) {
+            // warm up: wait for subscriptions to be accepted
+            service.set_rate(1000);
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            bool subscribed = false;
+            while (!subscribed && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                subscribed = true;
+                for (auto& client : clients) subscribed = subscribed && client->events() > 0;
+            }
+            HelloExample::drain(service, clients);
+            if (!subscribed) {
+                LOG_ERROR << "Not all clients received events, results may be incomplete" << LOG_CR;
+            }
+
+            LOG_INFO << "### Sweep: clients: " << config.clients << ", windows: " << config.windows.size()
+                    << ", rates: " << config.rates.size() << ", step: " << config.duration.count() << " ms" << LOG_CR;
+            HelloExample::print_csv_header(out);
+            for (int window : config.windows) {
+                for (double rate : config.rates) {
+                    HelloExample::run_step(service, clients, config, window, rate, out);
+                }
+            }
+            result = 0;
+        } else {
+            LOG_ERROR << "Failed starting applications" << LOG_CR;
+        }
+
+        for (auto& client : clients) client->stop();
+        service.stop();
+        routing.stop();
+    }
+    ::unlink(config_file.c_str());
+    return result;
+}
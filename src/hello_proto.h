@@ -22,6 +22,13 @@
 #define HELLO_EVENTGROUP_ID    0x0100
 #define HELLO_EVENT_ID         0x8005
 
+// [extension] load generator streams (hello_service --events N --groups M)
+// stream i uses event HELLO_LOAD_EVENT_ID + i in eventgroup HELLO_LOAD_EVENTGROUP_ID + (i % M)
+#define HELLO_LOAD_EVENT_ID       0x8100
+#define HELLO_LOAD_EVENTGROUP_ID  0x0200
+#define HELLO_LOAD_MAX_EVENTS     4096
+#define HELLO_LOAD_MAX_GROUPS     256
+
 /// IMPORTANT: should match vsomeip::DEFAULT_MAJOR in (interface/vsomeip/constants.hpp):
 // but Autosar works better if vsomeip::DEFAULT_MAJOR is 1 (thus Autosar needs custom vsomeip build)
 #define HELLO_SERVICE_MAJOR    (int)(vsomeip::DEFAULT_MAJOR) // 1u
@@ -39,6 +46,22 @@ struct HelloResponse {
     std::string reply;
 };
 
+// Non-owning string, e.g. borrowed from a received payload (valid while the payload is alive)
+struct StringView {
+    const char* data;
+    uint32_t size;
+};
+
+// HelloRequest decoded without copying the message from payload
+struct HelloRequestView {
+    StringView message;
+};
+
+// HelloResponse decoded without copying the reply from payload
+struct HelloResponseView {
+    StringView reply;
+};
+
 enum TimerID {
     Timer_1sec = 0,
     Timer_1min = 1,
@@ -68,4 +91,34 @@ struct HelloEvent {
 
 constexpr uint32_t HELLO_EVENT_PAYLOAD_SIZE = 17;
 
+// Clock used for HelloEventExt timestamps
+enum EventClock {
+    Clock_None = 0,      // no timestamp
+    Clock_Realtime = 1,  // CLOCK_REALTIME, comparable between hosts with synchronized clocks
+    Clock_Monotonic = 2, // CLOCK_MONOTONIC, comparable on the same host only
+};
+
+// [extension] HelloEvent followed by a trailer for end-to-end latency and loss measurements.
+// Clients not aware of the trailer still decode the HelloEvent part.
+struct HelloEventExt {
+    HelloEvent event;
+    // per TimerID event sequence number, starting from 1
+    uint32_t sequence;
+    EventClock clock_id;
+    // send timestamp in nanoseconds (clock_id)
+    int64_t timestamp_ns;
+};
+
+constexpr uint32_t HELLO_EVENT_EXT_PAYLOAD_SIZE = HELLO_EVENT_PAYLOAD_SIZE + 13;
+
+// [extension] Header of load generator events, padded up to the configured payload size
+struct HelloLoadEvent {
+    uint16_t stream;
+    uint32_t sequence; // per stream, starting from 1
+    EventClock clock_id;
+    int64_t timestamp_ns;
+};
+
+constexpr uint32_t HELLO_LOAD_HEADER_SIZE = 15;
+
 } // namespace HelloExample
@@ -16,22 +16,28 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <pthread.h>
+#include <algorithm>
 #include <csignal>
 #include <chrono>
 #include <random>
 #include <condition_variable>
+#include <cstdio>
 #include <iomanip>
 #include <iostream>
 #include <map>
 #include <sstream>
 #include <thread>
 #include <mutex>
+#include <vector>
 #include <cstring>
 
 #include <vsomeip/vsomeip.hpp>
 
+#include "hello_log.h"
 #include "hello_proto.h"
+#include "hello_stats.h"
 #include "hello_utils.h"
+#include "notify_batcher.h"
 #include "timer.h"
 
 static int debug = ::getenv("DEBUG") ? ::atoi(::getenv("DEBUG")) : 0;
@@ -43,15 +49,32 @@ static const std::string P_INFO  = COL_GREEN + "[HelloSrv] " + COL_WHITE_BOLD;
 static const std::string P_DEBUG = COL_GREEN + "[HelloSrv] " + COL_NONE;
 static const std::string P_TRACE = COL_YELLOW + "[HelloSrv] " + COL_BLUE;
 
-#define LOG_TRACE  std::cout << P_TRACE
-#define LOG_DEBUG  std::cout << P_DEBUG
-#define LOG_INFO   std::cout << P_INFO
-#define LOG_ERROR  std::cerr << P_ERROR
-// terminate log msg (reset colors and flush)
+// stream-style statements, queued to the async logger (see hello_log.h)
+#define LOG_TRACE  HELLO_LOG(HelloExample::LogLevel::Trace) << P_TRACE
+#define LOG_DEBUG  HELLO_LOG(HelloExample::LogLevel::Debug) << P_DEBUG
+#define LOG_INFO   HELLO_LOG(HelloExample::LogLevel::Info) << P_INFO
+#define LOG_ERROR  HELLO_LOG(HelloExample::LogLevel::Error) << P_ERROR
+// terminate log msg (reset colors), the line is queued at the end of the statement
 #define LOG_CR       COL_NONE << std::endl
 
+// captures integer args only, the formatter runs on the log thread (see HELLO_LOG_DEFERRED)
+#define LOG_DEBUG_DEFERRED(formatter, ...) \
+    HELLO_LOG_DEFERRED(HelloExample::LogLevel::Debug, formatter, __VA_ARGS__)
+
 namespace HelloExample {
 
+// on_message_cb() debug block, args: message type, service, instance, method, client, session, payload length
+static uint32_t format_on_message(const uint64_t* args, char* out, uint32_t size) {
+    const char* prefix = P_DEBUG.c_str();
+    const char* reset = COL_NONE.c_str();
+    int length = std::snprintf(out, size,
+            "%s%s\n%s### [SOME/IP] Received a %s for Service [%04x.%04x.%04x] to Client/Session [%04x/%04x] = (%u)%s\n%s%s\n",
+            prefix, reset, prefix, to_string(static_cast<vsomeip::message_type_e>(args[0])).c_str(),
+            (unsigned)args[1], (unsigned)args[2], (unsigned)args[3], (unsigned)args[4], (unsigned)args[5],
+            (unsigned)args[6], reset, prefix, reset);
+    return length < 0 ? 0 : static_cast<uint32_t>(length);
+}
+
 typedef std::map<TimerID, bool> timer_config;
 
 // HelloService Events enabled by default
@@ -62,6 +85,38 @@ timer_config timer_enabled = {
     { Timer_1ms,  false },
 };
 
+// If set, events are sent as HelloEventExt with sequence number (and send timestamp if event_clock is set)
+bool event_seq = ::getenv("EVENT_SEQ") ? ::atoi(::getenv("EVENT_SEQ")) != 0 : false;
+EventClock event_clock = Clock_None;
+
+// Load generator streams (--events), disabled by default
+struct load_config {
+    int events;    // number of event streams
+    int groups;    // number of eventgroups
+    int period_ms; // notification period for all streams
+    uint32_t size; // payload size, at least HELLO_LOAD_HEADER_SIZE
+};
+
+load_config load = { 0, 1, 10, HELLO_LOAD_HEADER_SIZE };
+
+// Timer events payload size, padded with a pattern if bigger than HelloEventExt (--size)
+uint32_t event_size = 0;
+
+// NO_TIMERS sender rate (events/s) and burst size (events), rate 0: unpaced
+double notify_rate = 0;
+double notify_burst = 0;
+
+// Timer events batching window (us) and max batch size, window 0: notify directly from the timer thread
+int64_t batch_window_us = 0;
+uint32_t batch_max = ::getenv("NOTIFY_BATCH_MAX") ? ::atoi(::getenv("NOTIFY_BATCH_MAX")) : 256;
+
+// Timer ID of the load streams timer (not a TimerID)
+constexpr int LOAD_TIMER_ID = 100;
+
+// ServiceStats indexes, timer events use timer_index()
+constexpr uint32_t METHOD_SAY_HELLO = 0;
+constexpr uint32_t EVENT_LOAD = TIMER_COUNT;
+
 const std::map<std::string, HelloExample::TimerID> TIMER_MAPPING = {
     { "1m",   HelloExample::Timer_1min },
     { "1s",   HelloExample::Timer_1sec },
@@ -131,6 +186,22 @@ private:
 
     // std::mutex payload_mutex_;
     std::map<TimerID, std::shared_ptr<vsomeip::payload>> payload_; // separate payloads per timer
+    std::map<TimerID, uint32_t> event_seq_; // last sent event sequence per timer
+
+    struct load_stream {
+        vsomeip::event_t event_id;
+        uint32_t sequence; // last sent sequence
+        std::shared_ptr<vsomeip::payload> payload;
+    };
+    std::vector<load_stream> load_streams_; // created in init(), notified from timer thread
+
+    std::unique_ptr<NotifyBatcher> batcher_; // timer events batching (--batch)
+    // notify_event() cost, updated from the notifying thread (timer or NO_TIMERS sender)
+    std::atomic<uint64_t> notify_count_;
+    std::atomic<int64_t> notify_cpu_ns_;
+    // per method / event counters, printed on stop() and SIGUSR1
+    ServiceStats rpc_stats_;
+    std::atomic<bool> stats_requested_;
 
     std::mutex shutdown_mutex_;
     std::condition_variable shutdown_condition_;
@@ -152,8 +223,17 @@ public:
             blocked_(false),
             running_(true),
             is_offered_(false),
+            notify_count_(0),
+            notify_cpu_ns_(0),
+            stats_requested_(false),
             shutdown_requested_(false) {
 
+        rpc_stats_.set_method_name(METHOD_SAY_HELLO, "SayHello");
+        for (int i = 0; i < TIMER_COUNT; i++) {
+            rpc_stats_.set_event_name(i, to_string(TIMER_IDS[i]));
+        }
+        rpc_stats_.set_event_name(EVENT_LOAD, "load");
+
         shutdown_thread_ = std::thread((std::bind(&hello_service::shutdown_th, this)));
         offer_thread_ = std::thread((std::bind(&hello_service::offer_th, this)));
         notify_thread_ = timer_0ms ?
@@ -199,10 +279,16 @@ public:
             HelloEvent event_10ms = { {}, Timer_10ms };
             HelloEvent event_1ms  = { {}, Timer_1ms };
 
-            serialize_hello_event(event_1m,   payload_[Timer_1min]);
-            serialize_hello_event(event_1s,   payload_[Timer_1sec]);
-            serialize_hello_event(event_10ms, payload_[Timer_10ms]);
-            serialize_hello_event(event_1ms,  payload_[Timer_1ms]);
+            for (const HelloEvent& event : { event_1m, event_1s, event_10ms, event_1ms }) {
+                event_seq_[event.timer_id] = 0;
+                if (event_seq) {
+                    // initial payload has the extended size, so notify_event() can reuse it
+                    HelloEventExt event_ext = { event, 0, event_clock, 0 };
+                    serialize_hello_event(event_ext, payload_[event.timer_id], event_size);
+                } else {
+                    serialize_hello_event(event, payload_[event.timer_id]);
+                }
+            }
         }
 
         //
@@ -234,6 +320,16 @@ public:
                 false, true, nullptr,
                 use_tcp_ ? vsomeip::reliability_type_e::RT_RELIABLE : vsomeip::reliability_type_e::RT_UNRELIABLE
             );
+        if (load.events > 0) {
+            init_load_streams();
+        }
+        if (batch_window_us > 0) {
+            batcher_.reset(new NotifyBatcher(
+                    std::bind(&hello_service::notify_batched, this,
+                            std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
+                    std::chrono::microseconds(batch_window_us), batch_max));
+            batcher_->start();
+        }
 
         blocked_ = true;
         condition_.notify_one();
@@ -244,46 +340,86 @@ public:
         app_->start();
     }
 
+    /**
+     * @brief Offers load.events events, each with its own event ID and payload buffer.
+     */
+    void init_load_streams() {
+        std::vector<vsomeip::byte_t> data(load.size);
+        fill_payload_pattern(data.data(), HELLO_LOAD_HEADER_SIZE, load.size);
+        load_streams_.reserve(load.events);
+        for (int i = 0; i < load.events; i++) {
+            load_stream stream = {
+                static_cast<vsomeip::event_t>(HELLO_LOAD_EVENT_ID + i), 0,
+                vsomeip::runtime::get()->create_payload()
+            };
+            stream.payload->set_data(data);
+
+            std::set<vsomeip::eventgroup_t> groups;
+            groups.insert(static_cast<vsomeip::eventgroup_t>(HELLO_LOAD_EVENTGROUP_ID + i % load.groups));
+            app_->offer_event(
+                    HELLO_SERVICE_ID, HELLO_INSTANCE_ID, stream.event_id,
+                    groups,
+                    vsomeip::event_type_e::ET_EVENT, std::chrono::milliseconds::zero(),
+                    false, true, nullptr,
+                    use_tcp_ ? vsomeip::reliability_type_e::RT_RELIABLE : vsomeip::reliability_type_e::RT_UNRELIABLE
+                );
+            load_streams_.push_back(stream);
+        }
+        LOG_INFO << "Offering " << load.events << " load events ["
+                << to_hex(HELLO_LOAD_EVENT_ID) << ".." << to_hex(HELLO_LOAD_EVENT_ID + load.events - 1)
+                << "] in " << load.groups << " eventgroups, period: " << load.period_ms
+                << " ms, size: " << load.size << LOG_CR;
+    }
+
     void on_message_cb(const std::shared_ptr<vsomeip::message> &_request) {
+        int64_t ts_start = now_ns();
         std::shared_ptr<vsomeip::payload> its_payload = _request->get_payload();
-        if (debug > 0) {
-            std::stringstream its_message;
-            its_message << "### [SOME/IP] Received a "
+        if (debug > 1) {
+            // payload dump, formatted in place
+            LOG_DEBUG << LOG_CR;
+            LOG_DEBUG << "### [SOME/IP] Received a "
                     << to_string(_request->get_message_type()) << " for Service ["
                     << to_hex(_request->get_service()) << "."
                     << to_hex(_request->get_instance()) << "."
                     << to_hex(_request->get_method()) << "] to Client/Session ["
                     << to_hex(_request->get_client()) << "/"
                     << to_hex(_request->get_session())
-                    << "] = (" << std::dec << its_payload->get_length() << ")";
-
-            if (debug > 1) {
-                its_message << " ["
-                    << bytes_to_string(its_payload->get_data(), its_payload->get_length()) << "]";
-            }
-
-            LOG_DEBUG << LOG_CR;
-            LOG_DEBUG << its_message.str() << LOG_CR;
+                    << "] = (" << std::dec << its_payload->get_length() << ") ["
+                    << bytes_to_string(its_payload->get_data(), its_payload->get_length()) << "]" << LOG_CR;
             LOG_DEBUG << LOG_CR;
+        } else if (debug > 0) {
+            // header fields only, format_on_message() runs on the log thread
+            LOG_DEBUG_DEFERRED(format_on_message, _request->get_message_type(),
+                    _request->get_service(), _request->get_instance(), _request->get_method(),
+                    _request->get_client(), _request->get_session(), its_payload->get_length());
         }
-        // TODO create and send response
+        // NOTE: the response message itself is still allocated by vsomeip
         std::shared_ptr<vsomeip::message> its_response = vsomeip::runtime::get()->create_response(_request);
-        std::shared_ptr<vsomeip::payload> resp_payload = vsomeip::runtime::get()->create_payload();
-
-        HelloRequest request;
-        if (deserialize_hello_request(request, its_payload)) {
-            if (debug > 0) LOG_DEBUG << "### [SOME/IP] received: '" << to_string(request) << "'" << LOG_CR;
+        // response payload is reused per dispatcher thread, app_->send() serializes it before returning
+        static thread_local std::shared_ptr<vsomeip::payload> resp_payload = vsomeip::runtime::get()->create_payload();
+
+        // request message is borrowed from its_payload
+        HelloRequestView request;
+        bool ok = deserialize_hello_request(request, its_payload);
+        if (ok) {
+            if (debug > 0) LOG_DEBUG << "### [SOME/IP] received: '" << request.message << "'" << LOG_CR;
         } else {
             LOG_ERROR << "### [SOME/IP] Failed to deserialize request payload!" << LOG_CR;
         }
 
         // sayHello should return "Hello " + request.message
-        HelloResponse response = { "Hello " + request.message };
-        serialize_hello_response(response, resp_payload);
+        static const StringView HELLO_PREFIX = { "Hello ", 6 };
+        serialize_hello_response(HELLO_PREFIX, request.message, resp_payload);
         its_response->set_payload(resp_payload);
 
-        if (debug > 0) LOG_DEBUG << "### [SOME/IP] Sending Response [" << to_string(response) << "]" << LOG_CR;
+        if (debug > 0) {
+            HelloResponseView response;
+            deserialize_hello_response(response, resp_payload);
+            LOG_DEBUG << "### [SOME/IP] Sending Response [" << response.reply << "]" << LOG_CR;
+        }
         app_->send(its_response);
+        rpc_stats_.on_request(METHOD_SAY_HELLO, its_payload->get_length(), resp_payload->get_length(), ok,
+                now_ns() - ts_start);
         if (debug > 1) LOG_TRACE << "[on_message_cb] done." << LOG_CR;
     }
 
@@ -306,15 +442,26 @@ public:
         }
     }
 
+    /*
+     * Called from signal handler to print stats from shutdown_th (async-signal-safe)
+     */
+    void stats_request() {
+        stats_requested_ = true;
+    }
+
     /**
      * Shutdown thread, waiting for shutdown_requested_ and calling stop() to minimize chances for deadlocks
-     * if invoked directly from signal handler.
+     * if invoked directly from signal handler. Also prints stats requested by SIGUSR1.
      */
     void shutdown_th() {
         std::unique_lock<std::mutex> its_lock(shutdown_mutex_);
         if (debug > 1) LOG_DEBUG << "[shutdown_th] waiting for shutdown..." << LOG_CR;
         while (!shutdown_requested_) {
-            shutdown_condition_.wait(its_lock);
+            shutdown_condition_.wait_for(its_lock, std::chrono::milliseconds(100));
+            if (stats_requested_.exchange(false)) {
+                log_flush();
+                rpc_stats_.print("Service stats");
+            }
         }
         if (debug > 0) LOG_DEBUG << "[shutdown_th] shutdown requested!" << LOG_CR;
         //std::this_thread::sleep_for(std::chrono::seconds(1));
@@ -347,6 +494,12 @@ public:
 
         if (debug > 0) LOG_DEBUG << "[stop] stopping timers..." << LOG_CR;
         timer_.stop_timers();
+        // stats below are printed directly to stdout
+        log_flush();
+        timer_.print_stats();
+        if (batcher_) {
+            batcher_->stop();
+        }
         if (std::this_thread::get_id() == offer_thread_.get_id()) {
             if (debug > 0) LOG_DEBUG << "[stop] detaching offer_thread..." << LOG_CR;
             offer_thread_.detach();
@@ -361,10 +514,30 @@ public:
             if (debug > 0) LOG_DEBUG << "[stop] joining notify_thread..." << LOG_CR;
             notify_thread_.join();
         }
+        print_notify_stats();
+        rpc_stats_.print("Service stats");
         if (debug > 0) LOG_DEBUG << "[stop] app->stop()" << LOG_CR;
         app_->stop();
     }
 
+    void print_notify_stats() {
+        uint64_t count = notify_count_.load(std::memory_order_relaxed);
+        if (count == 0) return;
+        int64_t post_ns = notify_cpu_ns_.load(std::memory_order_relaxed);
+        if (batcher_) {
+            // set_data() + notify() run on the sender thread, count them too so direct and batched compare
+            int64_t sender_ns = batcher_->sender_cpu_ns();
+            LOG_INFO << "[stop] notify_event(): " << count << " events, batched CPU: "
+                    << std::fixed << std::setprecision(3) << (post_ns + sender_ns) / 1000.0 / count
+                    << " us/event (post: " << post_ns / 1000.0 / count
+                    << ", sender: " << sender_ns / 1000.0 / count << ")" << LOG_CR;
+            batcher_->print_stats();
+        } else {
+            LOG_INFO << "[stop] notify_event(): " << count << " events, direct CPU: "
+                    << std::fixed << std::setprecision(3) << post_ns / 1000.0 / count << " us/event" << LOG_CR;
+        }
+    }
+
     void offer() {
         std::lock_guard<std::mutex> its_lock(notify_mutex_);
         LOG_INFO << "Application '" << app_->get_name() << "' offering Service ["
@@ -436,11 +609,58 @@ public:
     bool notify_event(HelloEvent& event) {
         if (!is_offered_ || !running_) return true; // not sending events..
 
+        int64_t cpu_start = thread_cpu_ns();
+        bool ok = batcher_ ? post_event(event) : notify_direct(event);
+        notify_cpu_ns_.fetch_add(thread_cpu_ns() - cpu_start, std::memory_order_relaxed);
+        notify_count_.fetch_add(1, std::memory_order_relaxed);
+        return ok;
+    }
+
+    /**
+     * @brief Encodes the event in the batch buffer, notify_batched() sends it from the batcher thread.
+     */
+    bool post_event(HelloEvent& event) {
+        int index = timer_index(event.timer_id);
+        if (index < 0) return false;
+        uint32_t sequence = ++event_seq_[event.timer_id];
+        if (event_seq) {
+            HelloEventExt event_ext = { event, sequence, event_clock, clock_now_ns(event_clock) };
+            uint32_t size = std::max(event_size, HELLO_EVENT_EXT_PAYLOAD_SIZE);
+            return batcher_->post(index, size, [&event_ext, size](vsomeip::byte_t* dst) {
+                serialize_hello_event(event_ext, dst, size);
+            });
+        }
+        return batcher_->post(index, HELLO_EVENT_PAYLOAD_SIZE, [&event](vsomeip::byte_t* dst) {
+            serialize_hello_event(event, dst, HELLO_EVENT_PAYLOAD_SIZE);
+        });
+    }
+
+    void notify_batched(uint32_t index, const vsomeip::byte_t* data, uint32_t size) {
+        // payload_ is used only by the batcher thread in batching mode. vsomeip has no multi-event notify,
+        // so each event is still copied (set_data reuses the payload capacity) and notified on its own.
+        const std::shared_ptr<vsomeip::payload>& payload = payload_[TIMER_IDS[index]];
+        payload->set_data(data, size);
+        int64_t ts_notify = now_ns();
+        app_->notify(HELLO_SERVICE_ID, HELLO_INSTANCE_ID, HELLO_EVENT_ID, payload);
+        rpc_stats_.on_notify(index, size, now_ns() - ts_notify);
+    }
+
+    bool notify_direct(HelloEvent& event) {
+        // event_seq_ keys are created in init(), timers are notified from a single thread
+        uint32_t sequence = ++event_seq_[event.timer_id];
         if (debug > 1) {
-            LOG_DEBUG << "[notify_event] ### " << to_string(event) << LOG_CR;
+            LOG_DEBUG << "[notify_event] ### " << to_string(event) << " #" << sequence << LOG_CR;
         }
         auto payload = payload_[event.timer_id];
-        if (!serialize_hello_event(event, payload)) {
+        bool ok;
+        if (event_seq) {
+            // timestamp as late as possible, vsomeip notify() latency is part of the measurement
+            HelloEventExt event_ext = { event, sequence, event_clock, clock_now_ns(event_clock) };
+            ok = serialize_hello_event(event_ext, payload, event_size);
+        } else {
+            ok = serialize_hello_event(event, payload);
+        }
+        if (!ok) {
             LOG_ERROR << "[notify_event] Failed to serialize event" << LOG_CR;
             return false;
         }
@@ -455,33 +675,116 @@ public:
                     << bytes_to_string(payload->get_data(), payload->get_length())
                     << "]" << LOG_CR;
         }
+        int64_t ts_notify = now_ns();
         app_->notify(HELLO_SERVICE_ID, HELLO_INSTANCE_ID, HELLO_EVENT_ID, payload);
+        rpc_stats_.on_notify(timer_index(event.timer_id), payload->get_length(), now_ns() - ts_notify);
         return true;
     }
 
     /**
-     * @brief Single-threaded event notification, sending Timer_1ms events without any delay.
+     * @brief Notifies all load streams, called from the timer thread each load.period_ms.
+     */
+    void notify_load_events() {
+        if (!is_offered_ || !running_) return;
+
+        HelloLoadEvent header = { 0, 0, event_clock, 0 };
+        for (size_t i = 0; i < load_streams_.size(); i++) {
+            load_stream& stream = load_streams_[i];
+            header.stream = static_cast<uint16_t>(i);
+            header.sequence = ++stream.sequence;
+            header.timestamp_ns = clock_now_ns(event_clock);
+            serialize_hello_load_event(header, stream.payload);
+            int64_t ts_notify = now_ns();
+            app_->notify(HELLO_SERVICE_ID, HELLO_INSTANCE_ID, stream.event_id, stream.payload);
+            rpc_stats_.on_notify(EVENT_LOAD, stream.payload->get_length(), now_ns() - ts_notify);
+        }
+        if (debug > 2) {
+            LOG_TRACE << "[notify_load_events] notified " << load_streams_.size()
+                    << " events, seq: " << header.sequence << LOG_CR;
+        }
+    }
+
+    /**
+     * @brief Single-threaded event notification, sending Timer_1ms events paced by a token bucket
+     * at notify_rate events/s, or without any delay if notify_rate is 0.
      */
     void notify0_th() {
         if (debug > 2) LOG_TRACE << "[notify0_th] started." << LOG_CR;
 
+        typedef TokenBucket::clock clock;
         HelloEvent event_1ms = { {}, Timer_1ms };
+        TokenBucket bucket(notify_rate, notify_burst > 0 ? notify_burst : notify_rate / 1000.0);
+        uint64_t total_sent = 0;
+        double total_time = 0; // seconds spent offered
+        int64_t total_notify_ns = 0;
+        double total_overflow = 0;
+
         while (running_) {
             // wait for service to be offered
-            std::unique_lock<std::mutex> its_lock(notify_mutex_);
-            while (!is_offered_ && running_) {
-                if (debug > 2) LOG_TRACE << "[notify0_th] waiting for is_offered_ ..." << LOG_CR;
-                notify_condition_.wait(its_lock);
+            {
+                std::unique_lock<std::mutex> its_lock(notify_mutex_);
+                while (!is_offered_ && running_) {
+                    if (debug > 2) LOG_TRACE << "[notify0_th] waiting for is_offered_ ..." << LOG_CR;
+                    notify_condition_.wait(its_lock);
+                }
             }
+            clock::time_point start = clock::now();
+            clock::time_point report = start;
+            uint64_t sent = 0;
+            uint64_t report_sent = 0;
+            double report_overflow = 0;
+            bucket.reset(start);
             // prevent busy loop when service is not offered
             while (is_offered_ && running_) {
+                clock::time_point now = clock::now();
+                clock::time_point ready;
+                if (notify_rate > 0 && !bucket.try_acquire(now, ready)) {
+                    TokenBucket::wait_until(ready);
+                    continue;
+                }
                 HelloExample::set_hello_event(event_1ms, std::chrono::high_resolution_clock::now());
                 notify_event(event_1ms);
+                sent++;
+                total_notify_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - now).count();
+
+                // per second pacing report, always shown with --rate
+                if ((notify_rate > 0 || debug > 0) && now - report >= std::chrono::seconds(1)) {
+                    std::chrono::duration<double> elapsed = now - report;
+                    print_rate("[notify0_th] rate", sent - report_sent, elapsed.count(),
+                            bucket.overflow() - report_overflow);
+                    report = now;
+                    report_sent = sent;
+                    report_overflow = bucket.overflow();
+                }
             }
+            std::chrono::duration<double> elapsed = clock::now() - start;
+            total_sent += sent;
+            total_time += elapsed.count();
+            total_overflow += bucket.overflow();
+        }
+        print_rate("[notify0_th] Sent " + std::to_string(total_sent) + " events,", total_sent, total_time, total_overflow);
+        if (total_sent > 0) {
+            LOG_INFO << "[notify0_th] Average notify cost: " << std::fixed << std::setprecision(3)
+                    << total_notify_ns / 1000.0 / total_sent << " us/event" << LOG_CR;
         }
         if (debug > 2) LOG_TRACE << "[notify0_th] finished." << LOG_CR;
     }
 
+    // achieved vs requested notify_rate
+    void print_rate(const std::string& prefix, uint64_t sent, double seconds, double overflow) {
+        double achieved = seconds > 0 ? sent / seconds : 0;
+        std::stringstream requested;
+        if (notify_rate > 0) {
+            requested << ", requested: " << std::fixed << std::setprecision(1) << notify_rate << " events/s ("
+                    << 100.0 * achieved / notify_rate << "%)"
+                    << ", missed tokens: " << std::setprecision(0) << overflow;
+        } else {
+            requested << ", unpaced";
+        }
+        LOG_INFO << prefix << " achieved: " << std::fixed << std::setprecision(1) << achieved << " events/s"
+                << requested.str() << LOG_CR;
+    }
+
     void notify_th() {
         if (debug > 2) LOG_TRACE << "[notify_th] started." << LOG_CR;
 
@@ -526,6 +829,14 @@ public:
                 to_int(Timer_1ms), 1, true);
             if (debug > 1) LOG_TRACE << "[notify_th] Timer_1ms enabled." << LOG_CR;
         }
+        if (!load_streams_.empty()) {
+            timer_.add_timer(
+                [this](int /*id*/) {
+                    notify_load_events();
+                },
+                LOAD_TIMER_ID, load.period_ms, true);
+            if (debug > 1) LOG_TRACE << "[notify_th] Load events enabled." << LOG_CR;
+        }
 
         while (running_) {
             std::unique_lock<std::mutex> its_lock(notify_mutex_);
@@ -552,6 +863,8 @@ static void handle_signal(int _signal) {
         // calling stop() from signal handler may cause deadlocks
         //its_sample_ptr->stop();
         its_sample_ptr->shutdown_request();
+    } else if (its_sample_ptr != nullptr && _signal == SIGUSR1) {
+        its_sample_ptr->stats_request();
     }
 }
 
@@ -564,14 +877,43 @@ void print_help(const char* name) {
             << "\n"
             << "  --timers <LIST> Enable HelloService events. List: [ID:ENABLED,ID:ENABLED,...], where ID:[1s,1m,10ms,1ms], ENABLED:[0,1]\n"
             << "                  Defaults: 1m:1,1s:1,10ms:0,1ms:0\n"
+            << "  --event-seq     Append per timer sequence number to events (for client loss/reorder stats).\n"
+            << "  --event-clock <CLOCK>  Append sequence number and send timestamp to events (for client latency stats).\n"
+            << "                  CLOCK: [none,realtime,monotonic]. Use monotonic only if client runs on the same host. Default: none\n"
+            << "\n"
+            << "  --events N      (load) Offer N additional events [1.." << HELLO_LOAD_MAX_EVENTS << "], all notified each --period.\n"
+            << "                  Event IDs: 0x" << std::hex << HELLO_LOAD_EVENT_ID << "+i, eventgroups: 0x"
+            << HELLO_LOAD_EVENTGROUP_ID << "+(i % groups)" << std::dec << "\n"
+            << "  --groups M      (load) Number of eventgroups for --events [1.." << HELLO_LOAD_MAX_GROUPS << "]. Default: 1\n"
+            << "  --period P      (load) Notification period, e.g. 5ms, 1s. Default: 10ms\n"
+            << "  --rate R        Replaces timers with a single Timer_1ms sender paced to R events/s, e.g. 1k, 10k, 100k.\n"
+            << "                  Prints achieved vs requested rate (implies NO_TIMERS=1, see NOTIFY_BURST).\n"
+            << "  --batch W       Batch timer events for up to W (e.g. 500us, 2ms) and send them from a single sender thread.\n"
+            << "                  Prints notify CPU time per event on exit (compare with W=0, direct notify). Default: 0\n"
+            << "  --size S        Event payload size in bytes, header followed by a pattern the client verifies.\n"
+            << "                  Applies to load events (min: " << HelloExample::HELLO_LOAD_HEADER_SIZE << ") and timer events"
+            << " (if > " << HelloExample::HELLO_EVENT_EXT_PAYLOAD_SIZE << ", implies --event-seq).\n"
+            << "                  NOTE: UDP payloads above ~1400 bytes need SOME/IP-TP config. Default: no padding\n"
             << "\n"
             << "ENVIRONMENT:\n"
             << "  TIMERS          Enabled timer list (same as --timers). Default: 1m:1,1s:1,10ms:0,1ms:0\n"
-            << "  DEBUG           Controls App verbosity (0=info, 1=debug, 2=trace). Default: 1\n"
+            << "  EVENT_SEQ       1=same as --event-seq. Default: 0\n"
+            << "  EVENT_CLOCK     Extended events clock (same as --event-clock). Default: none\n"
+            << "  DEBUG           Controls App verbosity (0=info, 1=debug, 2=trace). Default: 0\n"
             << "  TOGGLE_OFFER    (experimental) If set, toggles service offered state periodically. Default: disabled\n"
             << "  TIMER_CB_US     (experimental) Timer callback maximum delay (microseconds). Default: 0=disabled\n"
             << "  TIMER_DEBUG     (experimental) Timer debug level. Default: 0=disabled\n"
+            << "  TIMER_CATCHUP   (experimental) Missed timer deadlines policy: [burst,coalesce,skip]. Default: burst\n"
+            << "  TIMER_BACKEND   (experimental) Timer implementation: [cv,timerfd]. Default: cv\n"
+            << "  TIMER_SPIN_US   --rate pacer spins for the last N us of each wait (busy core). Default: 0\n"
             << "  NO_TIMERS       (experimental) if set, disables timers and sends tmer events without any delay.\n"
+            << "  NOTIFY_RATE     (experimental) NO_TIMERS events/s, paced by a token bucket, e.g. 1k, 10k, 100k. Default: 0=unpaced\n"
+            << "  NOTIFY_BURST    (experimental) NOTIFY_RATE max burst (events). Default: rate/1000\n"
+            << "  NOTIFY_BATCH_MAX (experimental) Max events per --batch flush. Default: 256\n"
+            << "  LOG_SYNC        1=write log lines synchronously instead of the async logger. Default: 0\n"
+            << "\n"
+            << "SIGNALS:\n"
+            << "  SIGUSR1         Prints per method / event service stats without stopping. Also printed on exit.\n"
             << "\n"
             << std::endl;
 }
@@ -584,15 +926,35 @@ int main(int argc, char **argv) {
     std::string tcp_enable("--tcp");
     std::string udp_enable("--udp");
     std::string timers_arg("--timers");
+    std::string event_seq_arg("--event-seq");
+    std::string events_arg("--events");
+    std::string groups_arg("--groups");
+    std::string period_arg("--period");
+    std::string size_arg("--size");
+    std::string rate_arg("--rate");
+    std::string batch_arg("--batch");
+    std::string event_clock_arg("--event-clock");
     std::string help_arg("--help");
 
     const char* app_config = ::getenv("VSOMEIP_CONFIGURATION");
     const char* app_name = ::getenv("VSOMEIP_APPLICATION_NAME");
     const char* timer_env = ::getenv("TIMERS");
+    const char* event_clock_env = ::getenv("EVENT_CLOCK");
+    const char* notify_rate_env = ::getenv("NOTIFY_RATE");
+    const char* notify_burst_env = ::getenv("NOTIFY_BURST");
 
     if (timer_env) {
         HelloExample::parse_timers(std::string(timer_env), HelloExample::timer_enabled);
     }
+    if (event_clock_env && !HelloExample::parse_event_clock(event_clock_env, HelloExample::event_clock)) {
+        LOG_ERROR << "Invalid EVENT_CLOCK: " << event_clock_env << LOG_CR;
+    }
+    if (notify_rate_env) {
+        HelloExample::notify_rate = std::max(0.0, HelloExample::parse_rate(notify_rate_env));
+    }
+    if (notify_burst_env) {
+        HelloExample::notify_burst = std::max(0.0, HelloExample::parse_rate(notify_burst_env));
+    }
 
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
@@ -610,6 +972,55 @@ int main(int argc, char **argv) {
                 print_help(argv[0]);
                 exit(1);
             }
+        } else if (events_arg == arg && i + 1 < argc) {
+            HelloExample::load.events = std::atoi(argv[++i]);
+            if (HelloExample::load.events < 1 || HelloExample::load.events > HELLO_LOAD_MAX_EVENTS) {
+                LOG_ERROR << "Invalid event count: " << argv[i] << LOG_CR;
+                exit(1);
+            }
+        } else if (groups_arg == arg && i + 1 < argc) {
+            HelloExample::load.groups = std::atoi(argv[++i]);
+            if (HelloExample::load.groups < 1 || HelloExample::load.groups > HELLO_LOAD_MAX_GROUPS) {
+                LOG_ERROR << "Invalid eventgroup count: " << argv[i] << LOG_CR;
+                exit(1);
+            }
+        } else if (period_arg == arg && i + 1 < argc) {
+            HelloExample::load.period_ms = HelloExample::parse_period_ms(argv[++i]);
+            if (HelloExample::load.period_ms <= 0) {
+                LOG_ERROR << "Invalid period: " << argv[i] << LOG_CR;
+                exit(1);
+            }
+        } else if (size_arg == arg && i + 1 < argc) {
+            int size = std::atoi(argv[++i]);
+            if (size < (int)HelloExample::HELLO_LOAD_HEADER_SIZE) {
+                LOG_ERROR << "Invalid payload size: " << argv[i] << LOG_CR;
+                exit(1);
+            }
+            HelloExample::load.size = size;
+            HelloExample::event_size = size;
+        } else if (batch_arg == arg && i + 1 < argc) {
+            HelloExample::batch_window_us = HelloExample::parse_duration_us(argv[++i]);
+            if (HelloExample::batch_window_us < 0) {
+                LOG_ERROR << "Invalid batch window: " << argv[i] << LOG_CR;
+                exit(1);
+            }
+        } else if (rate_arg == arg && i + 1 < argc) {
+            HelloExample::notify_rate = HelloExample::parse_rate(argv[++i]);
+            if (HelloExample::notify_rate <= 0) {
+                LOG_ERROR << "Invalid rate: " << argv[i] << LOG_CR;
+                exit(1);
+            }
+            timer_0ms = true;
+        } else if (event_seq_arg == arg) {
+            HelloExample::event_seq = true;
+        } else if (event_clock_arg == arg) {
+            std::string clock;
+            if (i + 1 < argc) clock = argv[++i];
+            if (!HelloExample::parse_event_clock(clock, HelloExample::event_clock)) {
+                LOG_ERROR << "Invalid event clock: " << clock << LOG_CR;
+                print_help(argv[0]);
+                exit(1);
+            }
         } else if (help_arg == arg) {
             print_help(argv[0]);
             exit(0);
@@ -620,8 +1031,16 @@ int main(int argc, char **argv) {
         }
     }
 
+    if (HelloExample::event_clock != HelloExample::Clock_None ||
+        HelloExample::event_size > HelloExample::HELLO_EVENT_EXT_PAYLOAD_SIZE) {
+        // timestamps and padding follow the sequence trailer
+        HelloExample::event_seq = true;
+    }
     if (debug > 0) {
         LOG_DEBUG << "[main] Enabled timers: " << HelloExample::map_to_string(HelloExample::timer_enabled) << LOG_CR;
+        LOG_DEBUG << "[main] Event sequence: " << HelloExample::event_seq
+                << ", clock: " << HelloExample::to_string(HelloExample::event_clock)
+                << ", size: " << HelloExample::event_size << LOG_CR;
     }
     if (vsomeip::DEFAULT_MAJOR != 0) {
         // custom vsomeip used, won't work with "stock" vsomeip clients
@@ -643,6 +1062,7 @@ int main(int argc, char **argv) {
     its_sample_ptr = &its_sample;
     signal(SIGINT, handle_signal);
     signal(SIGTERM, handle_signal);
+    signal(SIGUSR1, handle_signal);
 
     if (its_sample.init()) {
         its_sample.start();
@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#include "hello_stats.h"
+
+namespace HelloExample {
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::reset() {
+    for (uint32_t i = 0; i < BUCKETS; i++) {
+        buckets_[i].store(0, std::memory_order_relaxed);
+    }
+    count_ = 0;
+    sum_ = 0;
+    min_ = std::numeric_limits<int64_t>::max();
+    max_ = 0;
+}
+
+uint32_t LatencyHistogram::bucket_index(int64_t value) {
+    uint64_t v = value > 0 ? static_cast<uint64_t>(value) : 0;
+    if (v < SUB_COUNT) {
+        return static_cast<uint32_t>(v);
+    }
+    uint32_t msb = 63 - __builtin_clzll(v);
+    uint32_t shift = msb - SUB_BITS;
+    uint32_t sub = static_cast<uint32_t>(v >> shift) & (SUB_COUNT - 1);
+    return SUB_COUNT + shift * SUB_COUNT + sub;
+}
+
+int64_t LatencyHistogram::bucket_lower(uint32_t index) {
+    if (index < SUB_COUNT) {
+        return index;
+    }
+    uint32_t shift = (index - SUB_COUNT) / SUB_COUNT;
+    uint64_t sub = (index - SUB_COUNT) % SUB_COUNT;
+    return static_cast<int64_t>((SUB_COUNT + sub) << shift);
+}
+
+int64_t LatencyHistogram::bucket_upper(uint32_t index) {
+    if (index + 1 >= BUCKETS) {
+        return std::numeric_limits<int64_t>::max();
+    }
+    return bucket_lower(index + 1) - 1;
+}
+
+void LatencyHistogram::record(int64_t value) {
+    buckets_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+    int64_t current = min_.load(std::memory_order_relaxed);
+    while (value < current && !min_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    current = max_.load(std::memory_order_relaxed);
+    while (value > current && !max_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    uint64_t n = other.count();
+    if (n == 0) {
+        return;
+    }
+    for (uint32_t i = 0; i < BUCKETS; i++) {
+        uint64_t value = other.buckets_[i].load(std::memory_order_relaxed);
+        if (value > 0) buckets_[i].fetch_add(value, std::memory_order_relaxed);
+    }
+    count_.fetch_add(n, std::memory_order_relaxed);
+    sum_.fetch_add(other.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    int64_t value = other.min_.load(std::memory_order_relaxed);
+    int64_t current = min_.load(std::memory_order_relaxed);
+    while (value < current && !min_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    value = other.max_.load(std::memory_order_relaxed);
+    current = max_.load(std::memory_order_relaxed);
+    while (value > current && !max_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+double LatencyHistogram::mean() const {
+    uint64_t n = count();
+    return n > 0 ? sum_.load(std::memory_order_relaxed) / (double)n : 0.0;
+}
+
+int64_t LatencyHistogram::percentile(double percent) const {
+    uint64_t n = count();
+    if (n == 0) {
+        return 0;
+    }
+    uint64_t target = static_cast<uint64_t>(std::ceil(percent / 100.0 * n));
+    if (target == 0) target = 1;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < BUCKETS; i++) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            // bucket upper bound, but never above the recorded max
+            return std::min(bucket_upper(i), max());
+        }
+    }
+    return max();
+}
+
+bool LatencyHistogram::dump(const std::string& path, const std::string& header) const {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    if (!header.empty()) {
+        std::fprintf(file, "# %s\n", header.c_str());
+    }
+    std::fprintf(file, "# count: %lu, min: %ld, max: %ld, mean: %.1f\n", count(), min(), max(), mean());
+    std::fprintf(file, "# lower upper count\n");
+    for (uint32_t i = 0; i < BUCKETS; i++) {
+        uint64_t n = buckets_[i].load(std::memory_order_relaxed);
+        if (n > 0) {
+            std::fprintf(file, "%ld %ld %lu\n", bucket_lower(i), bucket_upper(i), n);
+        }
+    }
+    return std::fclose(file) == 0;
+}
+
+void EventCounter::reset() {
+    count.store(0, std::memory_order_relaxed);
+    bytes.store(0, std::memory_order_relaxed);
+    last_ts.store(0, std::memory_order_relaxed);
+    min_delta.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+    max_delta.store(std::numeric_limits<int64_t>::min(), std::memory_order_relaxed);
+}
+
+int64_t EventCounter::on_event(int64_t ts_ns, uint32_t payload_size) {
+    count.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(payload_size, std::memory_order_relaxed);
+    int64_t prev = last_ts.exchange(ts_ns, std::memory_order_relaxed);
+    if (prev == 0) {
+        return NO_DELTA;
+    }
+    int64_t delta = ts_ns - prev;
+    int64_t current = min_delta.load(std::memory_order_relaxed);
+    while (delta < current && !min_delta.compare_exchange_weak(current, delta, std::memory_order_relaxed)) {}
+    current = max_delta.load(std::memory_order_relaxed);
+    while (delta > current && !max_delta.compare_exchange_weak(current, delta, std::memory_order_relaxed)) {}
+    return delta;
+}
+
+void GapTracker::reset() {
+    std::memset(seen_, 0, sizeof(seen_));
+    highest_ = 0;
+    received_ = 0;
+    lost_ = 0;
+    duplicates_ = 0;
+    out_of_order_ = 0;
+    gaps_ = 0;
+    longest_gap_ = 0;
+    restarts_ = 0;
+}
+
+void GapTracker::set_seen(uint32_t sequence, bool seen) {
+    uint64_t mask = 1ull << (sequence % 64);
+    uint64_t& word = seen_[(sequence % WINDOW) / 64];
+    word = seen ? (word | mask) : (word & ~mask);
+}
+
+void GapTracker::start(uint32_t sequence) {
+    std::memset(seen_, 0, sizeof(seen_));
+    highest_ = sequence;
+    set_seen(sequence, true);
+}
+
+void GapTracker::on_sequence(uint32_t sequence) {
+    received_++;
+    if (highest_ == 0) {
+        // events sent before we subscribed are not lost
+        start(sequence);
+        return;
+    }
+    if (sequence > highest_) {
+        uint32_t gap = sequence - highest_ - 1;
+        if (gap > 0) {
+            lost_ += gap;
+            gaps_++;
+            longest_gap_ = std::max(longest_gap_, gap);
+        }
+        // forget flags of the sequences leaving the window
+        if (sequence - highest_ >= WINDOW) {
+            std::memset(seen_, 0, sizeof(seen_));
+        } else {
+            for (uint32_t s = highest_ + 1; s < sequence; s++) {
+                set_seen(s, false);
+            }
+        }
+        set_seen(sequence, true);
+        highest_ = sequence;
+    } else if (sequence == 1 && highest_ > 1) {
+        restarts_++;
+        start(sequence);
+    } else if (highest_ - sequence >= WINDOW) {
+        out_of_order_++; // too old to tell
+    } else if (is_seen(sequence)) {
+        duplicates_++;
+    } else {
+        // late arrival, was counted as lost
+        out_of_order_++;
+        if (lost_ > 0) lost_--;
+        set_seen(sequence, true);
+    }
+}
+
+void EventStreamStats::reset() {
+    latency.reset();
+    sequence.reset();
+    clock_skew = 0;
+    pattern_errors = 0;
+}
+
+void EventStreamStats::on_event(uint32_t seq, bool has_latency, int64_t latency_ns) {
+    sequence.on_sequence(seq);
+    if (has_latency) {
+        if (latency_ns >= 0) {
+            latency.record(latency_ns);
+        } else {
+            clock_skew++;
+        }
+    }
+}
+
+RequestTracker::RequestTracker() :
+    slots_(new std::atomic<int64_t>[SLOTS])
+{
+    reset();
+}
+
+void RequestTracker::reset() {
+    for (uint32_t i = 0; i < SLOTS; i++) {
+        slots_[i].store(0, std::memory_order_relaxed);
+    }
+    latency_.reset();
+}
+
+void RequestTracker::on_sent(uint16_t session, int64_t ts_ns) {
+    int64_t prev = slots_[session].exchange(ts_ns, std::memory_order_acq_rel);
+    if (prev < 0) {
+        // reply was faster than us
+        slots_[session].store(0, std::memory_order_release);
+        latency_.record(-prev - ts_ns);
+    }
+}
+
+void RequestTracker::on_reply(uint16_t session, int64_t ts_ns) {
+    int64_t sent = 0;
+    if (slots_[session].compare_exchange_strong(sent, -ts_ns, std::memory_order_acq_rel)) {
+        return; // on_sent() records the latency
+    }
+    if (sent > 0) {
+        slots_[session].store(0, std::memory_order_release);
+        latency_.record(ts_ns - sent);
+    }
+}
+
+constexpr uint32_t ServiceStats::MAX_METHODS;
+constexpr uint32_t ServiceStats::MAX_EVENTS;
+constexpr uint32_t ServiceStats::SHARDS;
+
+ServiceStats::ServiceStats() : shards_(new shard[SHARDS]) {
+    for (uint32_t i = 0; i < SHARDS; i++) {
+        for (method_counters& method : shards_[i].methods) {
+            method.requests = 0;
+            method.request_bytes = 0;
+            method.response_bytes = 0;
+            method.errors = 0;
+        }
+        for (event_counters& event : shards_[i].events) {
+            event.count = 0;
+            event.bytes = 0;
+        }
+    }
+}
+
+void ServiceStats::set_method_name(uint32_t method, const std::string& name) {
+    if (method < MAX_METHODS) method_names_[method] = name;
+}
+
+void ServiceStats::set_event_name(uint32_t event, const std::string& name) {
+    if (event < MAX_EVENTS) event_names_[event] = name;
+}
+
+ServiceStats::shard& ServiceStats::local_shard() {
+    static std::atomic<uint32_t> next_shard(0);
+    static thread_local uint32_t index = next_shard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+    return shards_[index];
+}
+
+void ServiceStats::on_request(uint32_t method, uint32_t request_bytes, uint32_t response_bytes, bool ok,
+        int64_t handler_ns) {
+    if (method >= MAX_METHODS) return;
+    method_counters& counters = local_shard().methods[method];
+    counters.requests.fetch_add(1, std::memory_order_relaxed);
+    counters.request_bytes.fetch_add(request_bytes, std::memory_order_relaxed);
+    counters.response_bytes.fetch_add(response_bytes, std::memory_order_relaxed);
+    if (!ok) counters.errors.fetch_add(1, std::memory_order_relaxed);
+    counters.handler_ns.record(handler_ns);
+}
+
+void ServiceStats::on_notify(uint32_t event, uint32_t bytes, int64_t notify_ns) {
+    if (event >= MAX_EVENTS) return;
+    shard& local = local_shard();
+    local.events[event].count.fetch_add(1, std::memory_order_relaxed);
+    local.events[event].bytes.fetch_add(bytes, std::memory_order_relaxed);
+    local.notify_ns.record(notify_ns);
+}
+
+void ServiceStats::print(const char* title) const {
+    std::printf("### %s\n", title);
+    std::unique_ptr<LatencyHistogram> latency(new LatencyHistogram());
+    for (uint32_t m = 0; m < MAX_METHODS; m++) {
+        if (method_names_[m].empty()) continue;
+        uint64_t requests = 0, request_bytes = 0, response_bytes = 0, errors = 0;
+        latency->reset();
+        for (uint32_t i = 0; i < SHARDS; i++) {
+            const method_counters& counters = shards_[i].methods[m];
+            requests += counters.requests.load(std::memory_order_relaxed);
+            request_bytes += counters.request_bytes.load(std::memory_order_relaxed);
+            response_bytes += counters.response_bytes.load(std::memory_order_relaxed);
+            errors += counters.errors.load(std::memory_order_relaxed);
+            latency->merge(counters.handler_ns);
+        }
+        std::printf("  - Method[%s] requests: %llu, in: %llu bytes, out: %llu bytes, errors: %llu\n",
+                method_names_[m].c_str(), (unsigned long long)requests, (unsigned long long)request_bytes,
+                (unsigned long long)response_bytes, (unsigned long long)errors);
+        if (latency->count() > 0) {
+            std::printf("    handler (us): avg: %.2f, p50: %.2f, p99: %.2f, p99.9: %.2f, max: %.2f\n",
+                    latency->mean() / 1e3, latency->percentile(50.0) / 1e3, latency->percentile(99.0) / 1e3,
+                    latency->percentile(99.9) / 1e3, latency->max() / 1e3);
+        }
+    }
+    latency->reset();
+    for (uint32_t i = 0; i < SHARDS; i++) {
+        latency->merge(shards_[i].notify_ns);
+    }
+    for (uint32_t e = 0; e < MAX_EVENTS; e++) {
+        if (event_names_[e].empty()) continue;
+        uint64_t count = 0, bytes = 0;
+        for (uint32_t i = 0; i < SHARDS; i++) {
+            count += shards_[i].events[e].count.load(std::memory_order_relaxed);
+            bytes += shards_[i].events[e].bytes.load(std::memory_order_relaxed);
+        }
+        if (count == 0) continue;
+        std::printf("  - Notify[%s] events: %llu, %llu bytes\n",
+                event_names_[e].c_str(), (unsigned long long)count, (unsigned long long)bytes);
+    }
+    if (latency->count() > 0) {
+        std::printf("    notify() (us): avg: %.2f, p50: %.2f, p99: %.2f, p99.9: %.2f, max: %.2f\n",
+                latency->mean() / 1e3, latency->percentile(50.0) / 1e3, latency->percentile(99.0) / 1e3,
+                latency->percentile(99.9) / 1e3, latency->max() / 1e3);
+    }
+    std::fflush(stdout);
+}
+
+} // namespace HelloExample
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include <stdint.h>
+#include <time.h>
+
+namespace HelloExample {
+
+// monotonic timestamp in nanoseconds (always > 0)
+inline int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// CPU time consumed by the calling thread (CLOCK_THREAD_CPUTIME_ID), nanoseconds
+inline int64_t thread_cpu_ns() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief HDR style latency histogram with lock-free, allocation-free recording.
+ *
+ * Values are bucketed by power of two with 2^SUB_BITS linear sub-buckets each, so the
+ * relative error of reported values is below 1 / 2^SUB_BITS (~3%) over the whole int64 range.
+ */
+class LatencyHistogram {
+public:
+    static constexpr uint32_t SUB_BITS = 5;
+    static constexpr uint32_t SUB_COUNT = 1u << SUB_BITS;
+    static constexpr uint32_t BUCKETS = SUB_COUNT + (64 - SUB_BITS) * SUB_COUNT;
+
+    LatencyHistogram();
+
+    void reset();
+    void record(int64_t value);
+    // adds all values recorded in other
+    void merge(const LatencyHistogram& other);
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    int64_t min() const { return count() > 0 ? min_.load(std::memory_order_relaxed) : 0; }
+    int64_t max() const { return max_.load(std::memory_order_relaxed); }
+    double mean() const;
+    // value at percentile [0..100], within bucket precision
+    int64_t percentile(double percent) const;
+
+    /**
+     * @brief Writes non-empty buckets as "<lower> <upper> <count>" lines.
+     * @return false if the file can't be written.
+     */
+    bool dump(const std::string& path, const std::string& header = "") const;
+
+    static uint32_t bucket_index(int64_t value);
+    static int64_t bucket_lower(uint32_t index);
+    static int64_t bucket_upper(uint32_t index);
+
+private:
+    std::atomic<uint64_t> buckets_[BUCKETS];
+    std::atomic<uint64_t> count_;
+    std::atomic<int64_t> sum_;
+    std::atomic<int64_t> min_;
+    std::atomic<int64_t> max_;
+};
+
+/**
+ * @brief Lock-free event counter with inter-arrival delta stats.
+ *
+ * Followed by a cache line of padding, so counters of different streams updated from different
+ * threads don't share cache lines. Not alignas(64): C++11 operator new doesn't honour it for
+ * heap allocated owners (e.g. hello_client --clients).
+ */
+struct EventCounter {
+    static constexpr int64_t NO_DELTA = std::numeric_limits<int64_t>::min();
+
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> bytes;    // payload bytes
+    std::atomic<int64_t> last_ts;   // timestamp of the last event (ns)
+    std::atomic<int64_t> min_delta; // ns between consecutive events
+    std::atomic<int64_t> max_delta;
+    char padding[64];
+
+    EventCounter() { reset(); }
+
+    void reset();
+    // returns delta to the previous event timestamp, or NO_DELTA for the first event
+    int64_t on_event(int64_t ts_ns, uint32_t payload_size);
+
+    int64_t delta_min() const {
+        int64_t value = min_delta.load(std::memory_order_relaxed);
+        return value == std::numeric_limits<int64_t>::max() ? 0 : value;
+    }
+    int64_t delta_max() const {
+        int64_t value = max_delta.load(std::memory_order_relaxed);
+        return value == std::numeric_limits<int64_t>::min() ? 0 : value;
+    }
+};
+
+/**
+ * @brief Detects lost, duplicated and out-of-order sequence numbers of an event stream.
+ *
+ * Remembers which of the last WINDOW sequence numbers were received, so late events can
+ * be told apart from duplicates. Events older than the window are counted as out-of-order.
+ * A sequence restarting from 1 (e.g. service restart) starts a new stream.
+ * Not thread safe.
+ */
+class GapTracker {
+public:
+    static constexpr uint32_t WINDOW = 1024;
+
+    GapTracker() { reset(); }
+
+    void reset();
+    void on_sequence(uint32_t sequence);
+
+    uint64_t received() const { return received_; }
+    // missing sequence numbers, late arrivals are subtracted
+    uint64_t lost() const { return lost_; }
+    uint64_t duplicates() const { return duplicates_; }
+    uint64_t out_of_order() const { return out_of_order_; }
+    // number of gaps and the longest one (in sequence numbers)
+    uint64_t gaps() const { return gaps_; }
+    uint32_t longest_gap() const { return longest_gap_; }
+    uint32_t restarts() const { return restarts_; }
+    uint32_t last_sequence() const { return highest_; }
+
+private:
+    bool is_seen(uint32_t sequence) const {
+        return (seen_[(sequence % WINDOW) / 64] >> (sequence % 64)) & 1u;
+    }
+    void set_seen(uint32_t sequence, bool seen);
+    void start(uint32_t sequence);
+
+    uint64_t seen_[WINDOW / 64]; // received flags of (highest_ - WINDOW, highest_]
+    uint32_t highest_;
+    uint64_t received_;
+    uint64_t lost_;
+    uint64_t duplicates_;
+    uint64_t out_of_order_;
+    uint64_t gaps_;
+    uint32_t longest_gap_;
+    uint32_t restarts_;
+};
+
+/**
+ * @brief One-way latency and sequence stats of a single event stream (e.g. TimerID).
+ *
+ * Not thread safe, updated from the thread receiving the events.
+ */
+struct EventStreamStats {
+    LatencyHistogram latency; // one-way latency in nanoseconds
+    GapTracker sequence;
+    uint64_t clock_skew; // events with negative latency (clocks not synchronized)
+    uint64_t pattern_errors; // padding not matching the expected pattern
+
+    EventStreamStats() { reset(); }
+
+    void reset();
+    // latency is recorded only if has_latency is set
+    void on_event(uint32_t sequence, bool has_latency, int64_t latency_ns);
+};
+
+/**
+ * @brief Matches replies to in-flight requests by SOME/IP session id.
+ *
+ * Send timestamps are kept in a slot per session id. Recording is lock-free and handles replies
+ * that arrive before on_sent() was called (session id is only known after application::send()).
+ */
+class RequestTracker {
+public:
+    RequestTracker();
+
+    void reset();
+
+    // call after sending the request, ts_ns is the timestamp before sending
+    void on_sent(uint16_t session, int64_t ts_ns);
+    // call when the reply is received
+    void on_reply(uint16_t session, int64_t ts_ns);
+
+    uint64_t completed() const { return latency_.count(); }
+    // request latency in nanoseconds
+    const LatencyHistogram& latency() const { return latency_; }
+
+private:
+    static constexpr uint32_t SLOTS = 0x10000; // 16 bit session id
+
+    // 0: free, >0: request send timestamp, <0: reply timestamp (reply received before on_sent)
+    std::unique_ptr<std::atomic<int64_t>[]> slots_;
+
+    LatencyHistogram latency_;
+};
+
+/**
+ * @brief Service side RPC and notify statistics with per-thread shards.
+ *
+ * Each recording thread gets its own shard (round robin if there are more threads than shards),
+ * so recording is a few uncontended relaxed atomic adds. print() sums all shards and may be
+ * called at any time from another thread.
+ */
+class ServiceStats {
+public:
+    static constexpr uint32_t MAX_METHODS = 2;
+    static constexpr uint32_t MAX_EVENTS = 8;
+    static constexpr uint32_t SHARDS = 8;
+
+    ServiceStats();
+
+    // set names before recording, unnamed methods / events are not printed
+    void set_method_name(uint32_t method, const std::string& name);
+    void set_event_name(uint32_t event, const std::string& name);
+
+    // handler_ns: time spent in the request handler, including sending the response
+    void on_request(uint32_t method, uint32_t request_bytes, uint32_t response_bytes, bool ok, int64_t handler_ns);
+    // notify_ns: duration of the application::notify() call
+    void on_notify(uint32_t event, uint32_t bytes, int64_t notify_ns);
+
+    void print(const char* title) const;
+
+private:
+    struct method_counters {
+        std::atomic<uint64_t> requests;
+        std::atomic<uint64_t> request_bytes;
+        std::atomic<uint64_t> response_bytes;
+        std::atomic<uint64_t> errors; // request deserialization failures
+        LatencyHistogram handler_ns;
+    };
+    struct event_counters {
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> bytes;
+    };
+    struct shard {
+        method_counters methods[MAX_METHODS];
+        event_counters events[MAX_EVENTS];
+        LatencyHistogram notify_ns;
+        char padding[64]; // heap allocation is not cache line aligned in C++11
+    };
+
+    shard& local_shard();
+
+    std::unique_ptr<shard[]> shards_;
+    std::string method_names_[MAX_METHODS];
+    std::string event_names_[MAX_EVENTS];
+};
+
+} // namespace HelloExample
@@ -15,28 +15,21 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <algorithm>
 #include <ctime>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <string>
 #include <sstream>
 
-#include <sys/time.h>
-
-#include "byteorder.hpp"
-
+#include "hello_codec.h"
 #include "hello_proto.h"
 #include "hello_utils.h"
 
 namespace HelloExample {
 
-// fwd declarations
-void serialize_int32(const int32_t value, std::vector<vsomeip::byte_t>& data);
-int32_t deserialize_int32(const vsomeip::byte_t* data, const uint32_t data_size, uint32_t &index);
-
-void serialize_string(const std::string& value, std::vector<vsomeip::byte_t>& serialized);
-std::string deserialize_string(const vsomeip::byte_t* data, const uint32_t data_size, uint32_t &index);
-
 template<typename ... Args>
 std::string string_format(const std::string& format, Args ... args)
 {
@@ -49,197 +42,307 @@ std::string string_format(const std::string& format, Args ... args)
     return std::string(buf, buf + len);
 }
 
-void serialize_int32(const int32_t value, std::vector<vsomeip::byte_t>& data) {
-    data.push_back(VSOMEIP_LONG_BYTE3(value));
-    data.push_back(VSOMEIP_LONG_BYTE2(value));
-    data.push_back(VSOMEIP_LONG_BYTE1(value));
-    data.push_back(VSOMEIP_LONG_BYTE0(value));
+std::string to_string(const std::vector<vsomeip::byte_t> &data) {
+    return bytes_to_string(data.data(), static_cast<uint32_t>(data.size()));
 }
 
-int32_t deserialize_int32(const vsomeip::byte_t* data, const uint32_t data_size, uint32_t &index) {
-    if (index + 4 >= data_size) {
-        // handle error
-        std::cerr << "FIXME: Invalid index: " << index << ", size: " << data_size << std::endl;
-        return -1;
-    }
-    uint32_t value = VSOMEIP_BYTES_TO_LONG(
-        data[index + 0],
-        data[index + 1],
-        data[index + 2],
-        data[index + 3]);
-
-    index = index + 4;
-    return value;
+bool serialize_hello_request(const HelloRequest& request, std::shared_ptr<vsomeip::payload> payload) {
+    // https://www.autosar.org/fileadmin/standards/R23-11/FO/AUTOSAR_FO_PRS_SOMEIPProtocol.pdf
+    // Strings should end with \0 char, UTF / Uniucode may be required for Autosar..
+    return codec::encode(request, payload);
 }
 
-std::string to_string(const std::vector<vsomeip::byte_t> &data) {
-    std::stringstream ss;
-    for (uint32_t i = 0; i < data.size(); ++i) {
-        ss << std::hex << std::setfill('0') << std::setw(2) << std::uppercase
-           << static_cast<int>(data[i]);
-        if (i < data.size() - 1) ss << " ";
+bool deserialize_hello_request(HelloRequest &request, std::shared_ptr<vsomeip::payload> payload) {
+    if (!codec::decode(request, payload)) {
+        request.message = {};
+        return false;
     }
-    return ss.str();
+    return true;
 }
 
-void serialize_string(const std::string& value, std::vector<vsomeip::byte_t>& serialized) {
-    // 6.2.4.4 Strings (dynamic length)
-    // [TR_SOMEIP_00091] d Strings with dynamic length start with a length field. The length
-    // is measured in Bytes and is followed by the "\0"-terminated string data
-    int str_size = value.size() + 1;
-    serialized.reserve(4 + str_size);
-    serialize_int32(str_size, serialized);
+std::string to_string(const HelloRequest& request) {
+    return request.message;
+}
 
-    // Append the raw bytes from the string
-    serialized.insert(serialized.end(), value.begin(), value.end());
-    serialized.push_back(0u); // add terminator char: '\x0'
+bool serialize_hello_response(const HelloResponse& response, std::shared_ptr<vsomeip::payload> payload) {
+    return codec::encode(response, payload);
 }
 
-std::string deserialize_string(const vsomeip::byte_t* data, const uint32_t data_size, uint32_t &index) {
-    if (index + 4 >= data_size) {
-        // handle error
-        std::cerr << "FIXME: Invalid index: " << index << ", size: " << data_size << std::endl;
-        return {};
-    }
-    int32_t str_size = deserialize_int32(data, data_size, index);
-    // sanity checks:
-    if (str_size > data_size - 4) {
-        std::cerr << "FIXME: Invalid string size: " << str_size << ", size: " << data_size << std::endl;
-        return {};
+bool deserialize_hello_response(HelloResponse &response, std::shared_ptr<vsomeip::payload> payload) {
+    if (!codec::decode(response, payload)) {
+        response.reply = {};
+        return false;
     }
-    return std::string(reinterpret_cast<const char*>(data) + index, str_size - 1);
+    return true;
+}
 
+std::string to_string(const HelloResponse& response) {
+    return response.reply;
 }
 
-bool serialize_hello_request(const HelloRequest& request, std::shared_ptr<vsomeip::payload> payload) {
-    // https://www.autosar.org/fileadmin/standards/R23-11/FO/AUTOSAR_FO_PRS_SOMEIPProtocol.pdf
-    // Strings should end with \0 char, UTF / Uniucode may be required for Autosar..
-#ifdef AUTOSAR_WIRE
-    std::vector<vsomeip::byte_t> serialized;
-    serialize_string(request.message, serialized);
-    payload->set_data(serialized);
-#else
-    const char *buffer = request.message.c_str();
-    payload->set_data(reinterpret_cast<const vsomeip_v3::byte_t*>(buffer), request.message.size() + 1);
-#endif
+bool deserialize_hello_request(HelloRequestView &request, const std::shared_ptr<vsomeip::payload>& payload) {
+    if (!codec::decode(request, payload)) {
+        request.message = {};
+        return false;
+    }
     return true;
 }
 
-bool deserialize_hello_request(HelloRequest &request, std::shared_ptr<vsomeip::payload> payload) {
-    // Get the data from the payload
-    vsomeip::byte_t* payload_data = payload->get_data();
-    std::size_t payload_length = payload->get_length();
-    // Convert the data to a string (skip thhe ending '\0')
-    if (payload_length > 0) {
-#ifdef AUTOSAR_WIRE
-        uint32_t index = 0;
-        request.message = deserialize_string(payload_data, payload_length, index);
-#else
-        request.message = std::string(reinterpret_cast<char*>(payload_data), payload_length - 1);
-#endif
-        return true;
+bool deserialize_hello_response(HelloResponseView &response, const std::shared_ptr<vsomeip::payload>& payload) {
+    if (!codec::decode(response, payload)) {
+        response.reply = {};
+        return false;
     }
-    request.message = {};
-    return false;
+    return true;
 }
 
-std::string to_string(const HelloRequest& request) {
-    return request.message;
+bool serialize_hello_response(const StringView& prefix, const StringView& message,
+        const std::shared_ptr<vsomeip::payload>& payload) {
+    typedef codec::string_wire<codec::layout_of<HelloResponse>::type> wire;
+    const uint32_t str_size = prefix.size + message.size + 1;
+    const uint32_t size = wire::header_size + str_size;
+    // per thread buffer, only allocates when a longer reply is built
+    static thread_local std::vector<vsomeip::byte_t> buffer;
+    if (buffer.size() < size) buffer.resize(size);
+
+    vsomeip::byte_t* dst = buffer.data();
+    wire::write_header(dst, str_size);
+    dst += wire::header_size;
+    if (prefix.size > 0) std::memcpy(dst, prefix.data, prefix.size);
+    if (message.size > 0) std::memcpy(dst + prefix.size, message.data, message.size);
+    dst[prefix.size + message.size] = 0u;
+    payload->set_data(buffer.data(), size);
+    return true;
 }
 
-bool serialize_hello_response(const HelloResponse& request, std::shared_ptr<vsomeip::payload> payload) {
-#ifdef AUTOSAR_WIRE
-    std::vector<vsomeip::byte_t> serialized;
-    serialize_string(request.reply, serialized);
-    payload->set_data(serialized);
-#else
-    const vsomeip_v3::byte_t* buffer = reinterpret_cast<const vsomeip_v3::byte_t*>(request.reply.c_str());
-    payload->set_data(buffer, request.reply.size() + 1);
-#endif
-    return true;
+std::ostream& operator<<(std::ostream& os, const StringView& view) {
+    os.write(view.data, view.size);
+    return os;
 }
 
-bool deserialize_hello_response(HelloResponse &response, std::shared_ptr<vsomeip::payload> payload) {
-    // Get the data from the payload
-    vsomeip::byte_t* payload_data = payload->get_data();
-    std::size_t payload_length = payload->get_length();
-
-    // Convert the data to a string (skip thhe ending '\0')
-    if (payload_length > 0) {
-        response.reply = std::string(reinterpret_cast<char*>(payload_data), payload_length - 1);
-        return true;
+constexpr uint32_t LocalTimeCache::TOD_BITS;
+constexpr uint64_t LocalTimeCache::INVALID;
+
+uint32_t LocalTimeCache::lookup(int64_t epoch_sec) {
+    uint64_t cached = cached_.load(std::memory_order_relaxed);
+    if (cached != INVALID && (cached >> TOD_BITS) == static_cast<uint64_t>(epoch_sec)) {
+        return static_cast<uint32_t>(cached & ((1u << TOD_BITS) - 1));
     }
-    response.reply = {};
-    return false;
+    std::time_t time_now = static_cast<std::time_t>(epoch_sec);
+    std::tm local_time;
+    ::localtime_r(&time_now, &local_time);
+    uint32_t tod = (local_time.tm_hour << 12) | (local_time.tm_min << 6) | local_time.tm_sec;
+
+    // only move forward, a late thread must not replace a newer second
+    uint64_t value = (static_cast<uint64_t>(epoch_sec) << TOD_BITS) | tod;
+    while ((cached == INVALID || (cached >> TOD_BITS) < static_cast<uint64_t>(epoch_sec)) &&
+            !cached_.compare_exchange_weak(cached, value, std::memory_order_relaxed)) {}
+    return tod;
 }
 
-std::string to_string(const HelloResponse& response) {
-    return response.reply;
+void LocalTimeCache::to_time_of_day(std::chrono::system_clock::time_point tp, TimeOfDay& time_of_day) {
+    int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+    int64_t epoch_sec = ns / 1000000000;
+    int32_t nanos = static_cast<int32_t>(ns % 1000000000);
+    if (nanos < 0) {
+        epoch_sec--;
+        nanos += 1000000000;
+    }
+    uint32_t tod = lookup(epoch_sec);
+    time_of_day.hours = tod >> 12;
+    time_of_day.minutes = (tod >> 6) & 0x3F;
+    time_of_day.seconds = tod & 0x3F;
+    time_of_day.nanos = nanos;
 }
 
+static LocalTimeCache local_time_cache;
+
 void init_hello_event(HelloEvent &event) {
-    // FIXME: Implementation in Autosar with the same behaviour is likely impossible
+    local_time_cache.to_time_of_day(std::chrono::system_clock::now(), event.time_of_day);
+}
 
-    // Get current time
-    struct timeval tv;
-    ::gettimeofday(&tv, NULL);
+void set_hello_event(HelloEvent &event, std::chrono::high_resolution_clock::time_point tp) {
+    local_time_cache.to_time_of_day(tp, event.time_of_day);
+}
 
-    // Convert to local time
-    time_t time_now = tv.tv_sec;
-    struct tm *now_tm = ::localtime(&time_now); // FIXME: Not threadsafe!
+bool deserialize_hello_event(HelloEvent &event, std::shared_ptr<vsomeip::payload> payload) {
+    return codec::decode(event, payload);
+}
 
-    // Extract hours, minutes, seconds
-    event.time_of_day.hours = now_tm->tm_hour;
-    event.time_of_day.minutes = now_tm->tm_min;
-    event.time_of_day.seconds = now_tm->tm_sec;
-    event.time_of_day.nanos = 1000 * tv.tv_usec; // micro to nano sec
+bool serialize_hello_event(const HelloEvent& event, vsomeip::byte_t* buffer, uint32_t size) {
+    return codec::encode(event, buffer, size) == HELLO_EVENT_PAYLOAD_SIZE;
 }
 
-void set_hello_event(HelloEvent &event, std::chrono::high_resolution_clock::time_point tp) {
-    // Convert to local time
-    std::time_t currentTime = std::chrono::system_clock::to_time_t(tp);
-    // Use localtime_r for thread safety
-    std::tm localTime;
-    ::localtime_r(&currentTime, &localTime);
-    // Get the time in nanoseconds
-    auto tp_ns = std::chrono::time_point_cast<std::chrono::nanoseconds>(tp);
-    long nanoseconds = tp_ns.time_since_epoch().count() % 1000000000;
+bool serialize_hello_event(const HelloEvent& event, std::shared_ptr<vsomeip::payload> payload) {
+    // reuses payload buffer from previous event, no allocations
+    return codec::encode(event, payload);
+}
 
-    event.time_of_day.hours = localTime.tm_hour;
-    event.time_of_day.minutes = localTime.tm_min;
-    event.time_of_day.seconds = localTime.tm_sec;
-    event.time_of_day.nanos = nanoseconds;
+bool serialize_hello_event(const HelloEventExt& event, const std::shared_ptr<vsomeip::payload>& payload,
+        uint32_t payload_size) {
+    if (payload_size <= HELLO_EVENT_EXT_PAYLOAD_SIZE) {
+        return codec::encode(event, payload);
+    }
+    if (payload->get_length() != payload_size) {
+        std::vector<vsomeip::byte_t> data(payload_size);
+        fill_payload_pattern(data.data(), HELLO_EVENT_EXT_PAYLOAD_SIZE, payload_size);
+        payload->set_data(std::move(data));
+    }
+    return codec::encode(event, payload->get_data(), payload->get_length()) == HELLO_EVENT_EXT_PAYLOAD_SIZE;
 }
 
-bool deserialize_hello_event(HelloEvent &event, std::shared_ptr<vsomeip::payload> payload) {
-    vsomeip::byte_t* data = payload->get_data();
-    vsomeip::length_t size = payload->get_length();
-    if (size < HELLO_EVENT_PAYLOAD_SIZE) {
+bool serialize_hello_event(const HelloEventExt& event, vsomeip::byte_t* buffer, uint32_t size) {
+    if (codec::encode(event, buffer, size) != HELLO_EVENT_EXT_PAYLOAD_SIZE) {
         return false;
     }
+    fill_payload_pattern(buffer, HELLO_EVENT_EXT_PAYLOAD_SIZE, size);
+    return true;
+}
 
-    uint32_t index = 0;
-    event.time_of_day.hours = deserialize_int32(data, size, index);
-    event.time_of_day.minutes = deserialize_int32(data, size, index);
-    event.time_of_day.seconds = deserialize_int32(data, size, index);
-    event.time_of_day.nanos = deserialize_int32(data, size, index);
-    event.timer_id = static_cast<TimerID>(data[index++]);
-    return (index == HELLO_EVENT_PAYLOAD_SIZE);
+bool deserialize_hello_event(HelloEventExt &event, const std::shared_ptr<vsomeip::payload>& payload) {
+    if (payload->get_length() >= HELLO_EVENT_EXT_PAYLOAD_SIZE) {
+        return codec::decode(event, payload);
+    }
+    event.sequence = 0;
+    event.clock_id = Clock_None;
+    event.timestamp_ns = 0;
+    return codec::decode(event.event, payload);
 }
 
-bool serialize_hello_event(const HelloEvent& event, std::shared_ptr<vsomeip::payload> payload) {
-    std::vector<vsomeip::byte_t> data;
-    serialize_int32(event.time_of_day.hours, data);
-    serialize_int32(event.time_of_day.minutes, data);
-    serialize_int32(event.time_of_day.seconds, data);
-    serialize_int32(event.time_of_day.nanos, data);
-    data.push_back(static_cast<vsomeip::byte_t>(event.timer_id));
-    payload->set_data(data);
-//    std::cout << "FIXME: <serialize_hello_event(" << to_string(event) << ") --> " << bytes_to_string(payload->get_data(), payload->get_length()) << std::endl;
+int64_t clock_now_ns(EventClock clock) {
+    struct timespec ts;
+    switch (clock) {
+        case Clock_Realtime:  ::clock_gettime(CLOCK_REALTIME, &ts); break;
+        case Clock_Monotonic: ::clock_gettime(CLOCK_MONOTONIC, &ts); break;
+        default: return 0;
+    }
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+bool parse_event_clock(const std::string& text, EventClock& clock) {
+    if (text == "none" || text == "0") {
+        clock = Clock_None;
+    } else if (text == "realtime") {
+        clock = Clock_Realtime;
+    } else if (text == "monotonic") {
+        clock = Clock_Monotonic;
+    } else {
+        return false;
+    }
     return true;
 }
 
-std::string to_string(const TimerID& id) {
+bool serialize_hello_load_event(const HelloLoadEvent& event, const std::shared_ptr<vsomeip::payload>& payload) {
+    // padding after the header is left untouched
+    return codec::encode(event, payload->get_data(), payload->get_length()) == HELLO_LOAD_HEADER_SIZE;
+}
+
+bool deserialize_hello_load_event(HelloLoadEvent& event, const std::shared_ptr<vsomeip::payload>& payload) {
+    return codec::decode(event, payload);
+}
+
+namespace {
+
+constexpr uint32_t PATTERN_PERIOD = 256;
+
+inline vsomeip::byte_t pattern_byte(uint32_t offset) {
+    return static_cast<vsomeip::byte_t>((offset % PATTERN_PERIOD) ^ 0xA5);
+}
+
+// two pattern periods, so any PATTERN_PERIOD long chunk can be compared with a single memcmp
+const vsomeip::byte_t* pattern_table() {
+    static const std::vector<vsomeip::byte_t> table = []() -> std::vector<vsomeip::byte_t> {
+        std::vector<vsomeip::byte_t> data(2 * PATTERN_PERIOD);
+        for (uint32_t i = 0; i < data.size(); i++) {
+            data[i] = pattern_byte(i);
+        }
+        return data;
+    }();
+    return table.data();
+}
+
+} // namespace
+
+void fill_payload_pattern(vsomeip::byte_t* data, uint32_t offset, uint32_t length) {
+    const vsomeip::byte_t* table = pattern_table();
+    for (uint32_t pos = offset; pos < length; ) {
+        uint32_t chunk = std::min(PATTERN_PERIOD, length - pos);
+        std::memcpy(data + pos, table + pos % PATTERN_PERIOD, chunk);
+        pos += chunk;
+    }
+}
+
+bool check_payload_pattern(const vsomeip::byte_t* data, uint32_t offset, uint32_t length) {
+    const vsomeip::byte_t* table = pattern_table();
+    for (uint32_t pos = offset; pos < length; ) {
+        uint32_t chunk = std::min(PATTERN_PERIOD, length - pos);
+        if (std::memcmp(data + pos, table + pos % PATTERN_PERIOD, chunk) != 0) {
+            return false;
+        }
+        pos += chunk;
+    }
+    return true;
+}
+
+int parse_period_ms(const std::string& text) {
+    char* end = nullptr;
+    long value = std::strtol(text.c_str(), &end, 10);
+    if (end == text.c_str() || value <= 0) {
+        return -1;
+    }
+    std::string unit(end);
+    if (unit.empty() || unit == "ms") {
+        return static_cast<int>(value);
+    } else if (unit == "s") {
+        return static_cast<int>(value * 1000);
+    }
+    return -1;
+}
+
+int64_t parse_duration_us(const std::string& text) {
+    char* end = nullptr;
+    long long value = std::strtoll(text.c_str(), &end, 10);
+    if (end == text.c_str() || value < 0) {
+        return -1;
+    }
+    std::string unit(end);
+    if (unit == "us") {
+        return value;
+    } else if (unit.empty() || unit == "ms") {
+        return value * 1000;
+    } else if (unit == "s") {
+        return value * 1000000;
+    }
+    return -1;
+}
+
+double parse_rate(const std::string& text) {
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    if (end == text.c_str() || value < 0) {
+        return -1;
+    }
+    std::string unit(end);
+    if (unit == "k") {
+        value *= 1000;
+    } else if (unit == "M") {
+        value *= 1000000;
+    } else if (!unit.empty()) {
+        return -1;
+    }
+    return value;
+}
+
+std::string to_string(EventClock clock) {
+    switch (clock) {
+        case Clock_None:      return "none";
+        case Clock_Realtime:  return "realtime";
+        case Clock_Monotonic: return "monotonic";
+        default: return "invalid";
+    }
+}
+
+const char* timer_name(TimerID id) {
     switch (id) {
         case Timer_1sec: return "T_1s";
         case Timer_1min: return "T_1m";
@@ -249,8 +352,12 @@ std::string to_string(const TimerID& id) {
     }
 }
 
+std::string to_string(const TimerID& id) {
+    return timer_name(id);
+}
+
 std::ostream& operator<<(std::ostream& os, const TimerID& id) {
-    os << to_string(id);
+    os << timer_name(id);
     return os;
 }
 
@@ -258,16 +365,66 @@ int to_int(const TimerID& id) {
     return static_cast<int>(id);
 }
 
+namespace {
+
+// "00".."99", two decimal digits per lookup
+const char DIGIT_PAIRS[] =
+    "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+    "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+const char HEX_DIGITS[] = "0123456789abcdef";
+
+// writes value with at least width digits (zero padded), returns the number of chars written
+inline size_t append_decimal(char* out, int32_t value, int width) {
+    char digits[12];
+    char* end = digits + sizeof(digits);
+    char* p = end;
+    uint32_t v = value < 0 ? 0u - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+    while (v >= 100) {
+        p -= 2;
+        std::memcpy(p, DIGIT_PAIRS + (v % 100) * 2, 2);
+        v /= 100;
+    }
+    if (v >= 10) {
+        p -= 2;
+        std::memcpy(p, DIGIT_PAIRS + v * 2, 2);
+    } else {
+        *--p = static_cast<char>('0' + v);
+    }
+    while (end - p < width) *--p = '0';
+    if (value < 0) *--p = '-';
+    std::memcpy(out, p, end - p);
+    return end - p;
+}
+
+} // namespace
+
+size_t format_hello_event(const HelloEvent& event, char* out) {
+    static const char PREFIX[] = "HelloEvent <";
+    char* p = out;
+    std::memcpy(p, PREFIX, sizeof(PREFIX) - 1);
+    p += sizeof(PREFIX) - 1;
+    const char* name = timer_name(event.timer_id);
+    size_t name_length = std::strlen(name);
+    std::memcpy(p, name, name_length);
+    p += name_length;
+    *p++ = '>';
+    // "<name>" is left aligned in 8 columns
+    for (size_t i = name_length + 2; i < 8; i++) *p++ = ' ';
+    *p++ = ' ';
+    p += append_decimal(p, event.time_of_day.hours, 2);
+    *p++ = ':';
+    p += append_decimal(p, event.time_of_day.minutes, 2);
+    *p++ = ':';
+    p += append_decimal(p, event.time_of_day.seconds, 2);
+    *p++ = '.';
+    p += append_decimal(p, event.time_of_day.nanos, 9);
+    *p = '\0';
+    return p - out;
+}
+
 std::string to_string(const HelloEvent& event) {
-    std::string event_str = "<" + to_string(event.timer_id) + ">";
-    std::stringstream ss;
-    ss << "HelloEvent "
-        << std::setfill(' ') << std::setw(8) << std::left << event_str << " "
-        << std::setfill('0') << std::setw(2) << (int)event.time_of_day.hours << ":"
-        << std::setfill('0') << std::setw(2) << (int)event.time_of_day.minutes << ":"
-        << std::setfill('0') << std::setw(2) << (int)event.time_of_day.seconds << "."
-        << std::setw(9) << std::setfill('0') << (unsigned)(event.time_of_day.nanos); // nanos to millis
-    return ss.str();
+    char text[HELLO_EVENT_STR_SIZE];
+    return std::string(text, format_hello_event(event, text));
 }
 
 std::chrono::time_point<std::chrono::high_resolution_clock> to_time_point(const HelloEvent& event) {
@@ -290,20 +447,27 @@ int timer_interval_ms(const TimerID& id) {
     return -1;
 }
 
+size_t format_hex(uint32_t value, char* out, int padding) {
+    int digits = 1;
+    while (digits < 8 && (value >> (digits * 4)) != 0) digits++;
+    if (padding > digits) digits = padding < 8 ? padding : 8;
+    for (int i = digits - 1; i >= 0; i--) {
+        out[i] = HEX_DIGITS[value & 0xf];
+        value >>= 4;
+    }
+    out[digits] = '\0';
+    return digits;
+}
+
 std::string to_hex(uint32_t value, int padding) {
-    std::stringstream ss;
-    ss << std::setfill('0') << std::setw(padding) << std::hex << (unsigned)value;
-    return ss.str();
+    char text[HEX_STR_SIZE];
+    return std::string(text, format_hex(value, text, padding));
 }
 
-std::string bytes_to_string(const vsomeip::byte_t *data, uint32_t length) {
-    std::stringstream ss;
-    for (uint32_t i = 0; i < length; ++i) {
-        ss << std::hex << std::setfill('0') << std::setw(2) << std::uppercase
-           << static_cast<int>(data[i]);
-        if (i < length - 1) ss << " ";
-    }
-    return ss.str();
+std::string bytes_to_string(const vsomeip::byte_t *data, uint32_t length, uint32_t max_bytes) {
+    std::string text(hex_dump_size(length, max_bytes), '\0');
+    text.resize(hex_dump(data, length, &text[0], max_bytes));
+    return text;
 }
 
 std::string to_string(vsomeip::message_type_e msg_type) {
@@ -17,11 +17,13 @@
  */
 #pragma once
 
+#include <atomic>
 #include <chrono>
 
 #include <stdint.h>
 #include <vsomeip/vsomeip.hpp>
 #include "hello_proto.h"
+#include "hex_dump.h"
 
 static const std::string COL_NONE = "\033[0m";
 static const std::string COL_RED = "\033[0;31m";
@@ -41,25 +43,109 @@ bool serialize_hello_response(const HelloResponse& request, std::shared_ptr<vsom
 bool deserialize_hello_response(HelloResponse &request, std::shared_ptr<vsomeip::payload> payload);
 std::string to_string(const HelloResponse& request);
 
+// Zero-copy decoding, views borrow from payload data
+bool deserialize_hello_request(HelloRequestView &request, const std::shared_ptr<vsomeip::payload>& payload);
+bool deserialize_hello_response(HelloResponseView &response, const std::shared_ptr<vsomeip::payload>& payload);
+// Encodes (prefix + message) as HelloResponse reply directly in payload
+bool serialize_hello_response(const StringView& prefix, const StringView& message,
+        const std::shared_ptr<vsomeip::payload>& payload);
+std::ostream& operator<<(std::ostream& os, const StringView& view);
+
+/**
+ * @brief Converts wall clock time to local TimeOfDay, calling localtime_r() only when the second changes.
+ *
+ * The cached second and its hours/minutes/seconds are packed in a single atomic word, so the cache
+ * is lock-free and safe to share between timer threads. Fractions are taken from the time point.
+ */
+class LocalTimeCache {
+public:
+    constexpr LocalTimeCache() : cached_(INVALID) {}
+
+    void to_time_of_day(std::chrono::system_clock::time_point tp, TimeOfDay& time_of_day);
+
+private:
+    // hours (5 bits), minutes (6 bits), seconds (6 bits, leap second safe)
+    static constexpr uint32_t TOD_BITS = 17;
+    static constexpr uint64_t INVALID = ~0ull;
+
+    uint32_t lookup(int64_t epoch_sec);
+
+    std::atomic<uint64_t> cached_; // (epoch seconds << TOD_BITS) | packed time of day
+};
+
 void init_hello_event(HelloEvent &event);
+// Sets event time of day from tp in local time (uses a shared LocalTimeCache)
 void set_hello_event(HelloEvent &event,
         std::chrono::high_resolution_clock::time_point tp = std::chrono::high_resolution_clock::now());
 
 bool serialize_hello_event(const HelloEvent& event, std::shared_ptr<vsomeip::payload> payload);
+// Encodes event in a preallocated buffer (size >= HELLO_EVENT_PAYLOAD_SIZE) without allocations
+bool serialize_hello_event(const HelloEvent& event, vsomeip::byte_t* buffer, uint32_t size);
 bool deserialize_hello_event(HelloEvent &event, std::shared_ptr<vsomeip::payload> payload);
+// If payload_size is bigger than HELLO_EVENT_EXT_PAYLOAD_SIZE, the event is followed by pattern padding.
+// Padding is written only if the payload length changes, later calls just update the header.
+bool serialize_hello_event(const HelloEventExt& event, const std::shared_ptr<vsomeip::payload>& payload,
+        uint32_t payload_size = 0);
+// Encodes event in a preallocated buffer, followed by pattern padding up to size (>= HELLO_EVENT_EXT_PAYLOAD_SIZE)
+bool serialize_hello_event(const HelloEventExt& event, vsomeip::byte_t* buffer, uint32_t size);
+// Decodes both payload formats, plain HelloEvent payloads set sequence=0, clock_id=Clock_None
+bool deserialize_hello_event(HelloEventExt &event, const std::shared_ptr<vsomeip::payload>& payload);
+// Current time of the specified clock in nanoseconds (0 for Clock_None)
+int64_t clock_now_ns(EventClock clock);
+bool parse_event_clock(const std::string& text, EventClock& clock);
+std::string to_string(EventClock clock);
+// Encodes the load event header in the first HELLO_LOAD_HEADER_SIZE bytes of payload
+bool serialize_hello_load_event(const HelloLoadEvent& event, const std::shared_ptr<vsomeip::payload>& payload);
+bool deserialize_hello_load_event(HelloLoadEvent& event, const std::shared_ptr<vsomeip::payload>& payload);
+// Padding pattern of variable size payloads, depends only on the byte offset in the payload
+void fill_payload_pattern(vsomeip::byte_t* data, uint32_t offset, uint32_t length);
+// Checks data[offset..length) against the pattern (memcmp speed)
+bool check_payload_pattern(const vsomeip::byte_t* data, uint32_t offset, uint32_t length);
+// Parses period as "<N>ms", "<N>s" or "<N>" (ms), returns milliseconds or -1
+int parse_period_ms(const std::string& text);
+// Parses duration as "<N>us", "<N>ms", "<N>s" or "<N>" (ms), returns microseconds or -1
+int64_t parse_duration_us(const std::string& text);
+// Parses rate as "<N>", "<N>k" or "<N>M" events/s, returns -1 if invalid
+double parse_rate(const std::string& text);
 std::string to_string(const HelloEvent& request);
+// Allocation-free formatters, write a NUL terminated string to out and return its length
+constexpr size_t HELLO_EVENT_STR_SIZE = 80;
+// "HelloEvent <T_1s>   HH:MM:SS.nnnnnnnnn", out: HELLO_EVENT_STR_SIZE bytes
+size_t format_hello_event(const HelloEvent& event, char* out);
 std::ostream& operator<<(std::ostream& os, const TimerID& id);
 std::chrono::time_point<std::chrono::high_resolution_clock> to_time_point(const HelloEvent& event);
 int timer_interval_ms(const TimerID& id);
 
+// Compact TimerID index for array lookups
+constexpr int TIMER_COUNT = 4;
+constexpr TimerID TIMER_IDS[TIMER_COUNT] = { Timer_1sec, Timer_1min, Timer_10ms, Timer_1ms };
+
+// returns [0..TIMER_COUNT) or -1 for invalid TimerID
+inline int timer_index(TimerID id) {
+    switch (id) {
+        case Timer_1sec: return 0;
+        case Timer_1min: return 1;
+        case Timer_10ms: return 2;
+        case Timer_1ms:  return 3;
+    }
+    return -1;
+}
+
 std::string to_string(const TimerID& id);
+// static string, e.g. "T_1s" ("T_inv" for unknown ids)
+const char* timer_name(TimerID id);
 int to_int(const TimerID& id);
 
 std::string to_string(vsomeip::return_code_e rc);
 
+// Uppercase hex dumps ("0A 1B 2C"), cut after max_bytes with a " ... (<length> bytes)" marker
 std::string to_string(const std::vector<vsomeip::byte_t> &data);
-std::string bytes_to_string(const vsomeip::byte_t *data, uint32_t length);
+std::string bytes_to_string(const vsomeip::byte_t *data, uint32_t length, uint32_t max_bytes = HEX_DUMP_LIMIT);
 std::string to_string(vsomeip::message_type_e msg_type);
+// lowercase hex, zero padded to padding digits (at most 8)
 std::string to_hex(uint32_t value, int padding=4);
+constexpr size_t HEX_STR_SIZE = 9;
+// to_hex() into out (HEX_STR_SIZE bytes)
+size_t format_hex(uint32_t value, char* out, int padding = 4);
 
 } // namespace HelloExample
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HEX_DUMP_X86 1
+#include <immintrin.h>
+#endif
+
+#include "hex_dump.h"
+
+namespace HelloExample {
+
+namespace {
+
+// " ... (4294967295 bytes)"
+constexpr size_t MARKER_SIZE = 24;
+
+// encodes length bytes as "XX " triplets (3 * length chars, including a trailing space)
+typedef void (*encode_fn)(const uint8_t* data, uint32_t length, char* out);
+
+// "XX " for each byte value, one 4 byte load and 3 byte store per input byte
+struct triplet_table {
+    char entries[256][4];
+    triplet_table() {
+        static const char HEX[] = "0123456789ABCDEF";
+        for (int i = 0; i < 256; i++) {
+            entries[i][0] = HEX[i >> 4];
+            entries[i][1] = HEX[i & 0xf];
+            entries[i][2] = ' ';
+            entries[i][3] = '\0';
+        }
+    }
+};
+
+const triplet_table TRIPLETS;
+
+void encode_scalar(const uint8_t* data, uint32_t length, char* out) {
+    for (uint32_t i = 0; i < length; i++) {
+        std::memcpy(out + 3 * i, TRIPLETS.entries[data[i]], 3);
+    }
+}
+
+#ifdef HEX_DUMP_X86
+
+/*
+ * SIMD layout: for 16 input bytes the hex digit pairs are unpacked into two vectors (pairs_lo: bytes
+ * 0..7, pairs_hi: bytes 8..15), then three pshufb steps spread them into 48 output chars with a zero
+ * (0x80 index) at each separator, which is OR-ed with ' '. Output char p belongs to byte p / 3.
+ */
+#define HEX_DUMP_ZZ -128
+#define HEX_DUMP_SP 0x20
+
+// out[0..15]: bytes 0..5 (last one without its second digit), from pairs_lo
+#define HEX_DUMP_SHUF0 0, 1, HEX_DUMP_ZZ, 2, 3, HEX_DUMP_ZZ, 4, 5, HEX_DUMP_ZZ, 6, 7, HEX_DUMP_ZZ, 8, 9, HEX_DUMP_ZZ, 10
+// out[16..31]: bytes 5..7 from pairs_lo, bytes 8..10 from pairs_hi
+#define HEX_DUMP_SHUF1_LO 11, HEX_DUMP_ZZ, 12, 13, HEX_DUMP_ZZ, 14, 15, HEX_DUMP_ZZ, \
+        HEX_DUMP_ZZ, HEX_DUMP_ZZ, HEX_DUMP_ZZ, HEX_DUMP_ZZ, HEX_DUMP_ZZ, HEX_DUMP_ZZ, HEX_DUMP_ZZ, HEX_DUMP_ZZ
+#define HEX_DUMP_SHUF1_HI HEX_DUMP_ZZ, HEX_DUMP_ZZ, HEX_DUMP_ZZ, HEX_DUMP_ZZ, HEX_DUMP_ZZ, HEX_DUMP_ZZ, \
+        HEX_DUMP_ZZ, HEX_DUMP_ZZ, 0, 1, HEX_DUMP_ZZ, 2, 3, HEX_DUMP_ZZ, 4, 5
+// out[32..47]: bytes 10..15 from pairs_hi
+#define HEX_DUMP_SHUF2 HEX_DUMP_ZZ, 6, 7, HEX_DUMP_ZZ, 8, 9, HEX_DUMP_ZZ, 10, 11, HEX_DUMP_ZZ, 12, 13, \
+        HEX_DUMP_ZZ, 14, 15, HEX_DUMP_ZZ
+#define HEX_DUMP_SPACES0 0, 0, HEX_DUMP_SP, 0, 0, HEX_DUMP_SP, 0, 0, HEX_DUMP_SP, 0, 0, HEX_DUMP_SP, 0, 0, HEX_DUMP_SP, 0
+#define HEX_DUMP_SPACES1 0, HEX_DUMP_SP, 0, 0, HEX_DUMP_SP, 0, 0, HEX_DUMP_SP, 0, 0, HEX_DUMP_SP, 0, 0, HEX_DUMP_SP, 0, 0
+#define HEX_DUMP_SPACES2 HEX_DUMP_SP, 0, 0, HEX_DUMP_SP, 0, 0, HEX_DUMP_SP, 0, 0, HEX_DUMP_SP, 0, 0, HEX_DUMP_SP, 0, 0, HEX_DUMP_SP
+#define HEX_DUMP_DIGITS '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
+
+__attribute__((target("ssse3")))
+void encode_ssse3(const uint8_t* data, uint32_t length, char* out) {
+    const __m128i digits = _mm_setr_epi8(HEX_DUMP_DIGITS);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    const __m128i shuf0 = _mm_setr_epi8(HEX_DUMP_SHUF0);
+    const __m128i shuf1_lo = _mm_setr_epi8(HEX_DUMP_SHUF1_LO);
+    const __m128i shuf1_hi = _mm_setr_epi8(HEX_DUMP_SHUF1_HI);
+    const __m128i shuf2 = _mm_setr_epi8(HEX_DUMP_SHUF2);
+    const __m128i spaces0 = _mm_setr_epi8(HEX_DUMP_SPACES0);
+    const __m128i spaces1 = _mm_setr_epi8(HEX_DUMP_SPACES1);
+    const __m128i spaces2 = _mm_setr_epi8(HEX_DUMP_SPACES2);
+
+    uint32_t i = 0;
+    for (; i + 16 <= length; i += 16, out += 48) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(in, 4), nibble));
+        __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(in, nibble));
+        __m128i pairs_lo = _mm_unpacklo_epi8(hi, lo);
+        __m128i pairs_hi = _mm_unpackhi_epi8(hi, lo);
+
+        __m128i out0 = _mm_or_si128(_mm_shuffle_epi8(pairs_lo, shuf0), spaces0);
+        __m128i out1 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(pairs_lo, shuf1_lo),
+                _mm_shuffle_epi8(pairs_hi, shuf1_hi)), spaces1);
+        __m128i out2 = _mm_or_si128(_mm_shuffle_epi8(pairs_hi, shuf2), spaces2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), out0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), out1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 32), out2);
+    }
+    encode_scalar(data + i, length - i, out);
+}
+
+__attribute__((target("avx2")))
+void encode_avx2(const uint8_t* data, uint32_t length, char* out) {
+    // vpshufb works within 128 bit lanes: lane 0 encodes bytes 0..15, lane 1 bytes 16..31
+    const __m256i digits = _mm256_setr_epi8(HEX_DUMP_DIGITS, HEX_DUMP_DIGITS);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const __m256i shuf0 = _mm256_setr_epi8(HEX_DUMP_SHUF0, HEX_DUMP_SHUF0);
+    const __m256i shuf1_lo = _mm256_setr_epi8(HEX_DUMP_SHUF1_LO, HEX_DUMP_SHUF1_LO);
+    const __m256i shuf1_hi = _mm256_setr_epi8(HEX_DUMP_SHUF1_HI, HEX_DUMP_SHUF1_HI);
+    const __m256i shuf2 = _mm256_setr_epi8(HEX_DUMP_SHUF2, HEX_DUMP_SHUF2);
+    const __m256i spaces0 = _mm256_setr_epi8(HEX_DUMP_SPACES0, HEX_DUMP_SPACES0);
+    const __m256i spaces1 = _mm256_setr_epi8(HEX_DUMP_SPACES1, HEX_DUMP_SPACES1);
+    const __m256i spaces2 = _mm256_setr_epi8(HEX_DUMP_SPACES2, HEX_DUMP_SPACES2);
+
+    uint32_t i = 0;
+    for (; i + 32 <= length; i += 32, out += 96) {
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hi = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(in, 4), nibble));
+        __m256i lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(in, nibble));
+        __m256i pairs_lo = _mm256_unpacklo_epi8(hi, lo);
+        __m256i pairs_hi = _mm256_unpackhi_epi8(hi, lo);
+
+        __m256i out0 = _mm256_or_si256(_mm256_shuffle_epi8(pairs_lo, shuf0), spaces0);
+        __m256i out1 = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(pairs_lo, shuf1_lo),
+                _mm256_shuffle_epi8(pairs_hi, shuf1_hi)), spaces1);
+        __m256i out2 = _mm256_or_si256(_mm256_shuffle_epi8(pairs_hi, shuf2), spaces2);
+        // out0/out1/out2 of lane 0 -> out[0..47], of lane 1 -> out[48..95]
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute2x128_si256(out0, out1, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 32), _mm256_permute2x128_si256(out2, out0, 0x30));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 64), _mm256_permute2x128_si256(out1, out2, 0x31));
+    }
+    encode_ssse3(data + i, length - i, out);
+}
+
+#endif // HEX_DUMP_X86
+
+encode_fn encoder(HexDumpImpl impl) {
+    switch (impl) {
+#ifdef HEX_DUMP_X86
+        case HexDump_AVX2:  return encode_avx2;
+        case HexDump_SSSE3: return encode_ssse3;
+#endif
+        default: return encode_scalar;
+    }
+}
+
+bool is_supported(HexDumpImpl impl) {
+    switch (impl) {
+        case HexDump_Scalar: return true;
+#ifdef HEX_DUMP_X86
+        case HexDump_SSSE3: return __builtin_cpu_supports("ssse3");
+        case HexDump_AVX2:  return __builtin_cpu_supports("avx2");
+#endif
+        default: return false;
+    }
+}
+
+std::atomic<encode_fn> selected_encoder(encoder(hex_dump_best()));
+
+} // namespace
+
+HexDumpImpl hex_dump_best() {
+#ifdef HEX_DUMP_X86
+    __builtin_cpu_init(); // may run from static initialization
+#endif
+    if (is_supported(HexDump_AVX2)) return HexDump_AVX2;
+    if (is_supported(HexDump_SSSE3)) return HexDump_SSSE3;
+    return HexDump_Scalar;
+}
+
+bool hex_dump_select(HexDumpImpl impl) {
+    if (!is_supported(impl)) return false;
+    selected_encoder.store(encoder(impl), std::memory_order_relaxed);
+    return true;
+}
+
+const char* to_string(HexDumpImpl impl) {
+    switch (impl) {
+        case HexDump_Scalar: return "scalar";
+        case HexDump_SSSE3:  return "ssse3";
+        case HexDump_AVX2:   return "avx2";
+    }
+    return "invalid";
+}
+
+size_t hex_dump_size(uint32_t length, uint32_t max_bytes) {
+    if (length > max_bytes) {
+        return 3 * static_cast<size_t>(max_bytes) + MARKER_SIZE;
+    }
+    return 3 * static_cast<size_t>(length) + 1;
+}
+
+size_t hex_dump(const uint8_t* data, uint32_t length, char* out, uint32_t max_bytes) {
+    uint32_t count = length < max_bytes ? length : max_bytes;
+    if (count > 0) {
+        selected_encoder.load(std::memory_order_relaxed)(data, count, out);
+    }
+    size_t end = 3 * static_cast<size_t>(count);
+    if (count < length) {
+        // keeps the separator of the last byte
+        int marker = std::snprintf(out + end, MARKER_SIZE, "... (%u bytes)", length);
+        return end + marker;
+    }
+    if (end == 0) {
+        out[0] = '\0';
+        return 0;
+    }
+    out[end - 1] = '\0'; // no trailing separator
+    return end - 1;
+}
+
+} // namespace HelloExample
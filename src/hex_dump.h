@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace HelloExample {
+
+// Default max bytes dumped by bytes_to_string(), keeps a dump within one log line
+constexpr uint32_t HEX_DUMP_LIMIT = 96;
+
+enum HexDumpImpl {
+    HexDump_Scalar = 0, // 3 byte lookup table per input byte
+    HexDump_SSSE3  = 1, // [x86] 16 input bytes per step, pshufb nibble lookup and space interleave
+    HexDump_AVX2   = 2, // [x86] 32 input bytes per step, same as SSSE3 in both 128 bit lanes
+};
+
+// Buffer size (with the terminating NUL) needed by hex_dump()
+size_t hex_dump_size(uint32_t length, uint32_t max_bytes);
+
+/**
+ * @brief Writes the first min(length, max_bytes) bytes of data as uppercase space separated hex
+ * ("0A 1B 2C"), followed by " ... (<length> bytes)" if cut, and a NUL.
+ *
+ * out must hold hex_dump_size(length, max_bytes) bytes. Returns the string length.
+ * Uses the fastest implementation supported by the CPU (see hex_dump_select()).
+ */
+size_t hex_dump(const uint8_t* data, uint32_t length, char* out, uint32_t max_bytes);
+
+// Best implementation supported by the CPU
+HexDumpImpl hex_dump_best();
+// Overrides the implementation used by hex_dump() (benchmarks), returns false if not supported
+bool hex_dump_select(HexDumpImpl impl);
+const char* to_string(HexDumpImpl impl);
+
+} // namespace HelloExample
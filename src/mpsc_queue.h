@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include <stdint.h>
+
+namespace HelloExample {
+
+/**
+ * @brief Bounded lock-free multi-producer / single-consumer queue of trivially copyable records.
+ *
+ * Each slot carries a sequence number (Vyukov style): producers claim a position with one CAS,
+ * the consumer never blocks producers. If the queue is full push() fails and the record is counted
+ * as dropped. Tracks the highest observed depth (high-water mark).
+ *
+ * claim() / publish() and front() / release() access records in place (e.g. the Logger ring, which
+ * formats lines straight into the slot), push() / pop() copy them.
+ */
+template<typename T>
+class MpscQueue {
+public:
+    // capacity is rounded up to a power of 2
+    explicit MpscQueue(uint32_t capacity) :
+            mask_(round_up(capacity) - 1), slots_(new slot[mask_ + 1]), head_(0), tail_(0), popped_(0),
+            dropped_(0), high_water_(0) {
+        for (uint32_t i = 0; i <= mask_; i++) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // any thread, returns false if full
+    bool push(const T& item) {
+        uint64_t pos;
+        T* cell = claim(pos);
+        if (!cell) return false;
+        *cell = item;
+        publish(pos);
+        return true;
+    }
+
+    // consumer thread only, returns false if empty
+    bool pop(T& item) {
+        const T* cell = front();
+        if (!cell) return false;
+        item = *cell;
+        release();
+        return true;
+    }
+
+    // any thread, claims the record at pos to be written in place, nullptr if full (counted as dropped)
+    T* claim(uint64_t& pos) {
+        pos = head_.load(std::memory_order_relaxed);
+        while (true) {
+            slot* cell = &slots_[pos & mask_];
+            uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(sequence - pos);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) return &cell->item;
+            } else if (diff < 0) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // makes the record claimed at pos visible to the consumer
+    void publish(uint64_t pos) {
+        slots_[pos & mask_].sequence.store(pos + 1, std::memory_order_release);
+
+        // depth including this record, may overestimate by records popped concurrently
+        uint32_t depth = static_cast<uint32_t>(pos + 1 - popped_.load(std::memory_order_relaxed));
+        uint32_t current = high_water_.load(std::memory_order_relaxed);
+        while (depth > current && !high_water_.compare_exchange_weak(current, depth, std::memory_order_relaxed)) {}
+    }
+
+    // consumer thread only, next published record (valid until release()), nullptr if none
+    T* front() {
+        slot& cell = slots_[tail_ & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != tail_ + 1) {
+            return nullptr;
+        }
+        return &cell.item;
+    }
+
+    // consumer thread only, frees the front() record
+    void release() {
+        slots_[tail_ & mask_].sequence.store(tail_ + mask_ + 1, std::memory_order_release);
+        tail_++;
+        popped_.store(tail_, std::memory_order_relaxed);
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == popped_.load(std::memory_order_acquire);
+    }
+
+    uint32_t capacity() const { return mask_ + 1; }
+    uint64_t pushed() const { return head_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint32_t high_water() const { return high_water_.load(std::memory_order_relaxed); }
+
+private:
+    struct slot {
+        std::atomic<uint64_t> sequence;
+        T item;
+    };
+
+    static uint32_t round_up(uint32_t value) {
+        uint32_t result = 2;
+        while (result < value && result < (1u << 31)) result <<= 1;
+        return result;
+    }
+
+    const uint32_t mask_;
+    std::unique_ptr<slot[]> slots_;
+    std::atomic<uint64_t> head_; // next position claimed by producers
+    char head_padding_[64];      // keeps producer and consumer counters on separate cache lines
+    uint64_t tail_;              // next position to pop, consumer only
+    std::atomic<uint64_t> popped_; // == tail_, for depth and empty() from other threads
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint32_t> high_water_;
+};
+
+} // namespace HelloExample
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <pthread.h>
+
+#include <algorithm>
+#include <cstdio>
+
+#include "hello_stats.h"
+#include "notify_batcher.h"
+
+namespace HelloExample {
+
+NotifyBatcher::NotifyBatcher(flush_callback callback, std::chrono::microseconds window, uint32_t max_events) :
+    callback_(callback),
+    window_(window),
+    max_events_(std::max(1u, max_events)),
+    running_(false),
+    batches_(0),
+    events_(0),
+    max_batch_(0),
+    delay_sum_us_(0),
+    delay_max_us_(0),
+    cpu_ns_(0)
+{
+    pending_.data.reserve(64 * 1024);
+    pending_.entries.reserve(max_events_);
+    sending_.data.reserve(64 * 1024);
+    sending_.entries.reserve(max_events_);
+}
+
+NotifyBatcher::~NotifyBatcher() {
+    stop();
+}
+
+void NotifyBatcher::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_ || thread_.joinable()) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread(std::bind(&NotifyBatcher::sender_thread, this));
+    pthread_setname_np(thread_.native_handle(), "notify_batch");
+}
+
+void NotifyBatcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        cv_.notify_one();
+    }
+    if (thread_.joinable() && std::this_thread::get_id() != thread_.get_id()) {
+        thread_.join();
+    }
+}
+
+void NotifyBatcher::sender_thread() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        while (running_ && pending_.entries.empty()) {
+            cv_.wait(lock);
+        }
+        // wait for the batch window, unless the batch is full or stopping
+        clock::time_point deadline = first_post_ + window_;
+        while (running_ && pending_.entries.size() < max_events_ && clock::now() < deadline) {
+            cv_.wait_until(lock, deadline);
+        }
+        if (pending_.entries.empty()) {
+            if (!running_) break;
+            continue;
+        }
+        std::swap(pending_, sending_);
+        clock::time_point first_post = first_post_;
+        lock.unlock();
+
+        int64_t cpu_start = thread_cpu_ns();
+        int64_t delay_us = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - first_post).count();
+        for (const entry& e : sending_.entries) {
+            callback_(e.key, sending_.data.data() + e.offset, e.size);
+        }
+        cpu_ns_ += thread_cpu_ns() - cpu_start;
+        batches_++;
+        events_ += sending_.entries.size();
+        max_batch_ = std::max<uint64_t>(max_batch_, sending_.entries.size());
+        delay_sum_us_ += delay_us;
+        delay_max_us_ = std::max(delay_max_us_, delay_us);
+        sending_.clear();
+
+        lock.lock();
+    }
+}
+
+void NotifyBatcher::print_stats() {
+    std::printf("  // NotifyBatcher[window=%ld us,max=%u] batches: %lu, events: %lu, avg batch: %.1f, max batch: %lu, "
+            "flush delay avg: %.1f us, max: %ld us, sender CPU: %.3f us/event\n",
+            (long)window_.count(), max_events_, batches_, events_,
+            batches_ > 0 ? events_ / (double)batches_ : 0.0, max_batch_,
+            batches_ > 0 ? delay_sum_us_ / (double)batches_ : 0.0, delay_max_us_,
+            events_ > 0 ? cpu_ns_ / 1000.0 / events_ : 0.0);
+}
+
+} // namespace HelloExample
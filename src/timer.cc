@@ -16,8 +16,17 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <pthread.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#endif
 
+#include <algorithm>
+#include <cerrno>
 #include <cmath>
+#include <cstring>
 #include <chrono>
 #include <iostream>
 #include <iomanip>
@@ -25,6 +34,7 @@
 #include <thread>
 #include <vector>
 #include <atomic>
+#include <string>
 
 #include "timer.h"
 #include "hello_utils.h"
@@ -33,79 +43,446 @@ namespace HelloExample {
 
 static int debug = ::getenv("TIMER_DEBUG") ? ::atoi(::getenv("TIMER_DEBUG")) : 0;
 static int timer_cb_max_us = ::getenv("TIMER_CB_US") ? ::atoi(::getenv("TIMER_CB_US")) : 0;
+// TokenBucket::wait_until() spins for the last TIMER_SPIN_US of a wait, 0: sleep only
+static int timer_spin_us = ::getenv("TIMER_SPIN_US") ? ::atoi(::getenv("TIMER_SPIN_US")) : 0;
+
+static TimerCatchUp parse_catch_up(const char* value) {
+    std::string policy = value ? value : "";
+    if (policy == "skip") return CatchUp_Skip;
+    if (policy == "coalesce") return CatchUp_Coalesce;
+    if (!policy.empty() && policy != "burst") {
+        std::printf("  // Invalid TIMER_CATCHUP: '%s', using 'burst'\n", value);
+    }
+    return CatchUp_Burst;
+}
+
+static const char* to_cstr(TimerCatchUp policy) {
+    switch (policy) {
+        case CatchUp_Burst:    return "burst";
+        case CatchUp_Coalesce: return "coalesce";
+        case CatchUp_Skip:     return "skip";
+        default:               return "invalid";
+    }
+}
+
+static TimerBackend parse_backend(const char* value) {
+    std::string backend = value ? value : "";
+    if (backend == "timerfd") return Backend_TimerFd;
+    if (!backend.empty() && backend != "cv") {
+        std::printf("  // Invalid TIMER_BACKEND: '%s', using 'cv'\n", value);
+    }
+    return Backend_CondVar;
+}
+
+static const char* to_cstr(TimerBackend backend) {
+    switch (backend) {
+        case Backend_CondVar: return "cv";
+        case Backend_TimerFd: return "timerfd";
+        default:              return "invalid";
+    }
+}
+
+Timer::timer_entry::timer_entry() :
+    handle(0), timer_id(0), interval(0), recurring(false),
+    missed(0), dispatched(0), latency_sum_us(0), latency_max_us(0),
+    fd(-1)
+{
+}
+
+Timer::timer_entry::~timer_entry() {
+    // closed after the last reference is gone, so dispatch thread never reads a reused fd
+    if (fd >= 0) ::close(fd);
+}
 
 Timer::Timer() :
-    is_running_(true)
+    Timer(parse_backend(::getenv("TIMER_BACKEND")))
 {
 }
 
+Timer::Timer(TimerBackend backend) :
+    is_running_(true),
+    catch_up_(parse_catch_up(::getenv("TIMER_CATCHUP"))),
+    backend_(backend),
+    epoll_fd_(-1),
+    wakeup_fd_(-1),
+    next_handle_(1)
+{
+#ifndef __linux__
+    if (backend_ == Backend_TimerFd) {
+        std::printf("  // Timer: timerfd backend not supported, using 'cv'\n");
+        backend_ = Backend_CondVar;
+    }
+#endif
+    if (debug > 0) std::printf("  // Timer::Timer(): backend: %s\n", to_cstr(backend_));
+}
+
 Timer::~Timer() {
     stop_timers();
-    if (debug > 0) std::printf("  // Timer::~Timer(): stopping %lu threads\n", threads_.size());
-    for (auto &thread : threads_) {
-        if (std::this_thread::get_id() == thread.get_id()) {
-            if (debug > 1) std::cout << "  // Timer::~Timer(): detaching thread: " << std::hex << thread.get_id() << std::endl;
-            thread.detach();
-        } else if (thread.joinable()) {
-            if (debug > 1) std::cout << "  // Timer::~Timer(): joining thread: " << std::hex << thread.get_id() << std::endl;
-            thread.join();
+    if (debug > 0) std::printf("  // Timer::~Timer(): stopping %lu timers, catch-up: %s\n", timers_.size(), to_cstr(catch_up_));
+    if (std::this_thread::get_id() == thread_.get_id()) {
+        if (debug > 1) std::cout << "  // Timer::~Timer(): detaching thread: " << std::hex << thread_.get_id() << std::endl;
+        thread_.detach();
+    } else if (thread_.joinable()) {
+        if (debug > 1) std::cout << "  // Timer::~Timer(): joining thread: " << std::hex << thread_.get_id() << std::endl;
+        thread_.join();
+    }
+    if (debug > 0) print_stats();
+    timers_.clear();
+    queue_.clear();
+    if (epoll_fd_ >= 0) ::close(epoll_fd_);
+    if (wakeup_fd_ >= 0) ::close(wakeup_fd_);
+}
+
+bool Timer::start_thread() {
+    // NOTE: mtx_ must be locked
+    if (thread_.joinable()) {
+        return true;
+    }
+#ifdef __linux__
+    if (backend_ == Backend_TimerFd) {
+        epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        wakeup_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.u64 = 0; // not a valid timer_handle
+        if (epoll_fd_ < 0 || wakeup_fd_ < 0 || ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &ev) < 0) {
+            std::printf("  // Timer::start_thread(): epoll setup failed: %s, using 'cv'\n", std::strerror(errno));
+            if (epoll_fd_ >= 0) ::close(epoll_fd_);
+            if (wakeup_fd_ >= 0) ::close(wakeup_fd_);
+            epoll_fd_ = -1;
+            wakeup_fd_ = -1;
+            backend_ = Backend_CondVar;
+        } else {
+            thread_ = std::thread(std::bind(&Timer::dispatch_fd_thread, this));
+        }
+    }
+#endif
+    if (backend_ == Backend_CondVar) {
+        thread_ = std::thread(std::bind(&Timer::dispatch_thread, this));
+    }
+    pthread_setname_np(thread_.native_handle(), "timer_dispatch");
+    return true;
+}
+
+timer_handle Timer::add_timer(timer_callback callback, int timer_id, int interval, bool recurring) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!is_running_ || !start_thread()) {
+        return 0;
+    }
+    std::shared_ptr<timer_entry> entry = std::make_shared<timer_entry>();
+    entry->handle = next_handle_++;
+    entry->timer_id = timer_id;
+    entry->interval = interval;
+    entry->recurring = recurring;
+    entry->callback = callback;
+    entry->next_expiration = clock::now() + std::chrono::milliseconds(interval);
+    if (backend_ == Backend_TimerFd) {
+        if (!arm_timerfd(*entry)) {
+            return 0;
         }
+    } else {
+        schedule(entry->next_expiration, entry->handle);
     }
-    threads_.clear();
+    timers_[entry->handle] = entry;
+
+    if (debug > 0) std::printf("  // Timer::add_timer[id=%d,timeout=%d] handle: %lu\n", timer_id, interval, entry->handle);
+    return entry->handle;
 }
 
-void Timer::add_timer(timer_callback callback, int timer_id, int interval, bool recurring) {
-    auto th = std::thread(
-            std::bind(&Timer::timer_thread, this,
-                    callback, timer_id, interval, recurring));
-    std::string th_name = "timer_" + std::to_string(timer_id);
-    pthread_setname_np(th.native_handle(), th_name.c_str());
-    threads_.push_back(std::move(th));
+bool Timer::arm_timerfd(timer_entry& entry) {
+#ifdef __linux__
+    entry.fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (entry.fd < 0) {
+        std::printf("  // Timer::add_timer[id=%d] timerfd_create failed: %s\n", entry.timer_id, std::strerror(errno));
+        return false;
+    }
+    // steady_clock is CLOCK_MONOTONIC, the kernel keeps the deadline grid for recurring timers
+    auto first = std::chrono::duration_cast<std::chrono::nanoseconds>(entry.next_expiration.time_since_epoch()).count();
+    auto period = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::milliseconds(entry.interval)).count();
+    struct itimerspec spec = {};
+    spec.it_value.tv_sec = first / 1000000000L;
+    spec.it_value.tv_nsec = first % 1000000000L;
+    if (entry.recurring) {
+        spec.it_interval.tv_sec = period / 1000000000L;
+        spec.it_interval.tv_nsec = period % 1000000000L;
+    }
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = entry.handle;
+    if (::timerfd_settime(entry.fd, TFD_TIMER_ABSTIME, &spec, NULL) < 0 ||
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, entry.fd, &ev) < 0) {
+        std::printf("  // Timer::add_timer[id=%d] arming timerfd failed: %s\n", entry.timer_id, std::strerror(errno));
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Timer::cancel_timer(timer_handle handle) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = timers_.find(handle);
+    bool found = it != timers_.end();
+    if (found) {
+#ifdef __linux__
+        if (it->second->fd >= 0) {
+            ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, it->second->fd, NULL);
+        }
+#endif
+        // pending deadlines of cancelled timers are dropped by the dispatch thread
+        timers_.erase(it);
+    }
+    if (debug > 0) std::printf("  // Timer::cancel_timer[handle=%lu] found: %d\n", handle, found);
+    return found;
 }
 
 void Timer::stop_timers() {
     if (debug > 0) std::printf("  // Timer::stop_timers(): is_running: %d\n", is_running_.load());
-    // std::unique_lock<std::mutex> lock(mtx_);
-    // if ((!is_running_ && threads_.size() == 0)) {
-    //     return;
-    // }
-    is_running_ = false;
-    cv_.notify_all(); // notify all waiting threads
-}
-
-void Timer::timer_thread(timer_callback callback, int timer_id, int interval, bool recurring) {
-    if (debug > 0) std::printf("  // timer_thread[id=%d,timeout=%d] started.\n", timer_id, interval);
-    const int64_t default_interval = interval * 1000L; // in us
-    int64_t to_wait_us = default_interval;
-    do {
-        // wait for the specified interval or until stop() is called
-        std::unique_lock<std::mutex> lock(mtx_);
-        if (debug > 1) std::printf("  // timer_thread[id=%d,timeout=%d] waiting(%ld us)....\n", timer_id, interval, to_wait_us);
-        if (cv_.wait_for(lock,
-                std::chrono::microseconds(to_wait_us), [=] {
-                    return !is_running_;
-                } )) {
-            if (debug > 0) std::printf("  // timer_thread[id=%d,timeout=%d] stop requested.\n", timer_id, interval);
-            break;
+    int wakeup_fd;
+    {
+        // update under lock, so dispatch thread can't miss the notification
+        std::lock_guard<std::mutex> lock(mtx_);
+        is_running_ = false;
+        wakeup_fd = wakeup_fd_; // set by start_thread() under mtx_
+    }
+    cv_.notify_all();
+    if (wakeup_fd >= 0) {
+        uint64_t one = 1;
+        if (::write(wakeup_fd, &one, sizeof(one)) < 0 && debug > 0) {
+            std::printf("  // Timer::stop_timers(): wakeup failed: %s\n", std::strerror(errno));
         }
-        if (!is_running_) break;
-        //if (debug > 2) std::printf("  // timer_thread[id=%d,timeout=%d] cb().\n", timer_id, interval);
+    }
+    // no callbacks run after stop_timers() returns (unless called from a callback),
+    // thread_ can't be restarted once is_running_ is cleared
+    if (thread_.joinable() && std::this_thread::get_id() != thread_.get_id()) {
+        thread_.join();
+    }
+}
+
+void Timer::set_catch_up(TimerCatchUp policy) {
+    catch_up_ = policy;
+}
+
+void Timer::print_stats() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (const auto& it : timers_) {
+        const timer_entry& entry = *it.second;
+        std::printf("  // Timer[id=%d,timeout=%d,%s] dispatched: %lu, overruns: %lu, wakeup latency avg: %.1f us, max: %ld us\n",
+            entry.timer_id, entry.interval, to_cstr(backend_),
+            entry.dispatched, entry.missed,
+            entry.dispatched > 0 ? entry.latency_sum_us / (double)entry.dispatched : 0.0,
+            entry.latency_max_us);
+    }
+}
+
+Timer::clock::time_point Timer::next_deadline(timer_entry& entry, clock::time_point scheduled, clock::time_point now) {
+    const clock::duration interval = std::chrono::milliseconds(entry.interval);
+    clock::time_point next = scheduled + interval;
+    if (next > now || interval <= clock::duration::zero()) {
+        return next; // on time
+    }
+    // number of grid deadlines in [next, now]
+    int64_t overdue = (now - next) / interval + 1;
+    TimerCatchUp policy = catch_up_;
+    if (debug > 1) std::printf("  // dispatch_thread[id=%d,timeout=%d] %ld deadlines overdue (%s)\n",
+        entry.timer_id, entry.interval, overdue, to_cstr(policy));
+    switch (policy) {
+        case CatchUp_Coalesce:
+            entry.missed += overdue - 1;
+            return next + (overdue - 1) * interval; // last overdue deadline, fires immediately
+        case CatchUp_Skip:
+            entry.missed += overdue;
+            return next + overdue * interval; // first deadline in the future
+        case CatchUp_Burst:
+        default:
+            return next; // fires immediately, late expirations are counted when dispatched
+    }
+}
+
+void Timer::schedule(clock::time_point when, timer_handle handle) {
+    // NOTE: mtx_ must be locked
+    bool earliest = queue_.empty() || when < queue_.front().when;
+    queue_.push_back({ when, handle });
+    std::push_heap(queue_.begin(), queue_.end());
+    if (earliest) {
+        cv_.notify_one(); // dispatch thread has to wait for the new deadline
+    }
+}
+
+void Timer::dispatch(timer_entry& entry, clock::time_point deadline, uint64_t expirations) {
+    // NOTE: called without mtx_ lock, entry stats are only updated from the dispatch thread
+    int64_t latency_us = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - deadline).count();
+    entry.latency_sum_us += latency_us;
+    entry.latency_max_us = std::max(entry.latency_max_us, latency_us);
+    for (uint64_t i = 0; i < expirations && is_running_; i++) {
         auto ts = std::chrono::high_resolution_clock::now();
-        callback(timer_id); // call the user callback
+        entry.callback(entry.timer_id); // call the user callback
+        entry.dispatched++;
         std::chrono::duration<double, std::micro> elapsed = std::chrono::high_resolution_clock::now() - ts;
-        to_wait_us = default_interval - elapsed.count();
-        if (debug > 1) std::printf("  // timer_thread[id=%d,timeout=%d] cb took %.4f ms\n",
-            timer_id, interval, (elapsed.count()) / 1000.0);
-        if (to_wait_us < 1) {
-            to_wait_us = 1; // WARNING: busy loop!
-        }
+        if (debug > 1) std::printf("  // dispatch_thread[id=%d,timeout=%d] cb took %.4f ms\n",
+            entry.timer_id, entry.interval, (elapsed.count()) / 1000.0);
         if (timer_cb_max_us > 0 && elapsed.count() > timer_cb_max_us) {
-            std::printf("  %s/!\\%s timer_thread[id=%d,timeout=%-4d] callback delayed for: %7.3f ms, next wait: %7.3f ms.\n",
+            std::printf("  %s/!\\%s dispatch_thread[id=%d,timeout=%-4d] callback delayed for: %7.3f ms.\n",
                 COL_RED.c_str(), COL_NONE.c_str(),
-                timer_id, interval, (elapsed.count()) / 1000.0, to_wait_us / 1000.0);
+                entry.timer_id, entry.interval, (elapsed.count()) / 1000.0);
+        }
+    }
+}
+
+void Timer::dispatch_thread() {
+    if (debug > 0) std::printf("  // dispatch_thread started.\n");
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (is_running_) {
+        if (queue_.empty()) {
+            cv_.wait(lock, [this] {
+                return !is_running_ || !queue_.empty();
+            });
+            continue;
+        }
+        const deadline next = queue_.front();
+        if (clock::now() < next.when) {
+            if (debug > 2) std::printf("  // dispatch_thread waiting for handle=%lu...\n", next.handle);
+            // re-evaluate the heap after each wakeup, an earlier timer may have been added
+            cv_.wait_until(lock, next.when);
+            continue;
+        }
+        std::pop_heap(queue_.begin(), queue_.end());
+        queue_.pop_back();
+
+        auto it = timers_.find(next.handle);
+        if (it == timers_.end()) {
+            continue; // cancelled
+        }
+        std::shared_ptr<timer_entry> entry = it->second;
+        if (!entry->recurring) {
+            timers_.erase(it);
+        }
+        bool late = clock::now() - next.when >= std::chrono::milliseconds(entry->interval);
+        if (late) {
+            entry->missed++; // late for at least one interval
+        }
+
+        if (!late || !entry->recurring || catch_up_ != CatchUp_Skip) {
+            lock.unlock();
+            dispatch(*entry, next.when, 1);
+            lock.lock();
         }
-    } while (recurring);
-    if (debug > 0) std::printf("  // timer_thread[id=%d,timeout=%d] finished.\n", timer_id, interval);
+
+        if (entry->recurring && is_running_ && timers_.count(entry->handle) > 0) {
+            // next deadline is relative to the scheduled (not actual) expiration
+            schedule(next_deadline(*entry, next.when, clock::now()), entry->handle);
+        }
+    }
+    if (debug > 0) std::printf("  // dispatch_thread finished.\n");
+}
+
+void Timer::dispatch_fd_thread() {
+#ifdef __linux__
+    if (debug > 0) std::printf("  // dispatch_fd_thread started.\n");
+    const int MAX_EVENTS = 64;
+    struct epoll_event events[MAX_EVENTS];
+    while (is_running_) {
+        int n = ::epoll_wait(epoll_fd_, events, MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::printf("  // dispatch_fd_thread epoll_wait failed: %s\n", std::strerror(errno));
+            break;
+        }
+        for (int i = 0; i < n && is_running_; i++) {
+            timer_handle handle = events[i].data.u64;
+            if (handle == 0) {
+                continue; // woken up by stop_timers()
+            }
+            std::shared_ptr<timer_entry> entry;
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                auto it = timers_.find(handle);
+                if (it == timers_.end()) {
+                    continue; // cancelled
+                }
+                entry = it->second;
+                if (!entry->recurring) {
+                    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, entry->fd, NULL);
+                    timers_.erase(it);
+                }
+            }
+            uint64_t expirations = 0;
+            if (::read(entry->fd, &expirations, sizeof(expirations)) != sizeof(expirations) || expirations == 0) {
+                continue; // EAGAIN
+            }
+            clock::time_point deadline = entry->next_expiration;
+            const clock::duration interval = std::chrono::milliseconds(entry->interval);
+            entry->next_expiration += static_cast<int64_t>(expirations) * interval;
+            TimerCatchUp policy = catch_up_;
+            if (expirations > 1 && debug > 1) std::printf("  // dispatch_fd_thread[id=%d,timeout=%d] %lu expirations (%s)\n",
+                entry->timer_id, entry->interval, expirations, to_cstr(policy));
+            if (policy == CatchUp_Skip && entry->recurring &&
+                    (expirations > 1 || clock::now() - (entry->next_expiration - interval) >= interval)) {
+                // overrun, drop all expirations and wait for the next deadline (same as the cv backend)
+                entry->missed += expirations;
+                continue;
+            }
+            // expirations > 1 means the kernel timer overran while we were busy
+            entry->missed += expirations - 1;
+            if (policy != CatchUp_Burst) {
+                // the overrun expirations are already gone, coalesce and skip dispatch the current one only
+                deadline = entry->next_expiration - interval;
+                expirations = 1;
+            }
+            dispatch(*entry, deadline, expirations);
+        }
+    }
+    if (debug > 0) std::printf("  // dispatch_fd_thread finished.\n");
+#endif
+}
+
+TokenBucket::TokenBucket(double rate, double burst) :
+    rate_(rate),
+    burst_(std::max(2.0, burst)),
+    tokens_(0),
+    overflow_(0)
+{
+    reset();
+}
+
+void TokenBucket::reset(clock::time_point now) {
+    tokens_ = burst_;
+    overflow_ = 0;
+    last_ = now;
+}
+
+bool TokenBucket::try_acquire(clock::time_point now, clock::time_point& ready) {
+    if (now > last_) {
+        std::chrono::duration<double> elapsed = now - last_;
+        tokens_ += elapsed.count() * rate_;
+        last_ = now;
+        if (tokens_ > burst_) {
+            overflow_ += tokens_ - burst_;
+            tokens_ = burst_;
+        }
+    }
+    if (tokens_ >= 1.0) {
+        tokens_ -= 1.0;
+        return true;
+    }
+    // wait for half a bucket rather than a single token: at high rates 1 / rate is too short to sleep
+    double refill = std::max(1.0, burst_ / 2);
+    ready = now + std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double>((refill - tokens_) / rate_));
+    return false;
+}
+
+void TokenBucket::wait_until(clock::time_point when) {
+    // e.g. 100 us, typical sleep_until() overshoot on a non-RT kernel
+    static const clock::duration SPIN_THRESHOLD = std::chrono::microseconds(std::max(0, timer_spin_us));
+    clock::time_point now = clock::now();
+    if (when - now > SPIN_THRESHOLD) {
+        std::this_thread::sleep_until(when - SPIN_THRESHOLD);
+    }
+    while (SPIN_THRESHOLD > clock::duration::zero() && clock::now() < when) {
+        std::this_thread::yield();
+    }
 }
 
 } // namespace HelloExample
@@ -18,30 +18,172 @@
 #pragma once
 
 #include <vector>
+#include <map>
+#include <memory>
 #include <thread>
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <condition_variable>
+#include <cstdint>
 
 namespace HelloExample {
 
 typedef std::function<void(int timer_id)> timer_callback;
 
+// Policy for recurring timers, applied when the dispatch thread is late for one or more deadlines
+enum TimerCatchUp {
+    CatchUp_Burst = 0,    // fire every missed expiration back to back (keeps event count)
+    CatchUp_Coalesce = 1, // fire once for all missed expirations
+    CatchUp_Skip = 2,     // drop missed expirations, wait for the next deadline
+};
+
+// Timer dispatch implementation, selected when Timer is created
+enum TimerBackend {
+    Backend_CondVar = 0, // min-heap of deadlines, condition_variable::wait_until()
+    Backend_TimerFd = 1, // [Linux] one timerfd (CLOCK_MONOTONIC, TFD_TIMER_ABSTIME) per timer, multiplexed by epoll
+};
+
+// Identifies a timer returned by Timer::add_timer(), 0 is never a valid handle.
+typedef uint64_t timer_handle;
+
+/**
+ * @brief Timer scheduler running all timers on a single dispatch thread.
+ *
+ * Pending expirations are kept in a min-heap ordered by absolute (steady_clock) deadline,
+ * the dispatch thread sleeps until the earliest deadline and invokes the callbacks in order.
+ * Recurring timers stay on their initial deadline grid (start + N * interval), so callback and
+ * wakeup latency does not accumulate. Missed deadlines are handled by the TimerCatchUp policy.
+ * Callbacks are called from the dispatch thread and should not block.
+ */
 class Timer {
 public:
     Timer();
+    explicit Timer(TimerBackend backend);
     ~Timer();
 
-    void add_timer(timer_callback callback, int timer_id, int interval, bool recurring=false);
+    /**
+     * @brief Adds a new timer, first expiration is after @p interval ms.
+     * @return handle for cancel_timer(), or 0 if timers are already stopped.
+     */
+    timer_handle add_timer(timer_callback callback, int timer_id, int interval, bool recurring=false);
+
+    /**
+     * @brief Cancels a pending timer. If its callback is running, it won't be rescheduled.
+     * @return false if the handle is unknown (already finished or cancelled).
+     */
+    bool cancel_timer(timer_handle handle);
+
+    /**
+     * @brief Stops all timers and joins the dispatch thread (if not called from a callback).
+     */
     void stop_timers();
 
+    /**
+     * @brief Sets the catch-up policy for recurring timers (default: TIMER_CATCHUP env or CatchUp_Burst).
+     */
+    void set_catch_up(TimerCatchUp policy);
+
+    TimerBackend backend() const { return backend_; }
+
+    /**
+     * @brief Prints per timer dispatch statistics (expirations, overruns, wakeup latency).
+     */
+    void print_stats();
+
 private:
-    void timer_thread(timer_callback callback, int timer_id, int interval, bool recurring);
+    typedef std::chrono::steady_clock clock;
+
+    struct timer_entry {
+        timer_entry();
+        ~timer_entry(); // closes fd
+
+        timer_handle handle;
+        int timer_id;
+        int interval; // ms
+        bool recurring;
+        timer_callback callback;
+        uint64_t missed; // expirations dropped or dispatched late by at least one interval
+        // dispatch statistics
+        uint64_t dispatched;
+        int64_t latency_sum_us; // wakeup latency (dispatch time - deadline)
+        int64_t latency_max_us;
+        // Backend_TimerFd
+        int fd;
+        clock::time_point next_expiration;
+    };
+
+    struct deadline {
+        clock::time_point when;
+        timer_handle handle;
+        // std::push_heap() builds a max-heap, invert ordering to get the earliest deadline on top
+        bool operator<(const deadline& other) const { return when > other.when; }
+    };
 
-    std::vector<std::thread> threads_;
+    void dispatch_thread();
+    void dispatch_fd_thread();
+    bool start_thread();
+    bool arm_timerfd(timer_entry& entry);
+    void dispatch(timer_entry& entry, clock::time_point deadline, uint64_t expirations);
+    void schedule(clock::time_point when, timer_handle handle);
+    clock::time_point next_deadline(timer_entry& entry, clock::time_point scheduled, clock::time_point now);
+
+    std::thread thread_;
     std::atomic<bool> is_running_;
+    std::atomic<TimerCatchUp> catch_up_;
+    TimerBackend backend_;
+    int epoll_fd_; // Backend_TimerFd
+    int wakeup_fd_; // eventfd, interrupts epoll_wait() on stop
     std::condition_variable cv_;
     std::mutex mtx_;
+
+    // guarded by mtx_
+    std::vector<deadline> queue_; // min-heap of pending expirations
+    std::map<timer_handle, std::shared_ptr<timer_entry>> timers_; // active timers
+    timer_handle next_handle_;
+};
+
+/**
+ * @brief Token bucket pacer for a single sender thread.
+ *
+ * Tokens are added at @p rate per second, up to @p burst tokens (at least 2, so sleep overshoot
+ * is absorbed). Tokens that don't fit in the bucket are counted as overflow, i.e. the sender was
+ * not fast enough to keep the requested rate.
+ * Not thread safe.
+ */
+class TokenBucket {
+public:
+    typedef std::chrono::steady_clock clock;
+
+    TokenBucket(double rate, double burst);
+
+    // starts with a full bucket
+    void reset(clock::time_point now = clock::now());
+
+    /**
+     * @brief Takes a token if available.
+     * @param ready set to the time when half a bucket (at least one token) is available again
+     * (if false is returned), so the sender sleeps once per batch instead of once per token.
+     */
+    bool try_acquire(clock::time_point now, clock::time_point& ready);
+
+    /**
+     * @brief Waits until @p when. Sleeps by default, TIMER_SPIN_US=N spins for the last N us
+     * (sleep_until() overshoot) at the cost of a busy core.
+     */
+    static void wait_until(clock::time_point when);
+
+    double rate() const { return rate_; }
+    double burst() const { return burst_; }
+    // tokens discarded because the bucket was full
+    double overflow() const { return overflow_; }
+
+private:
+    double rate_;
+    double burst_;
+    double tokens_;
+    double overflow_;
+    clock::time_point last_;
 };
 
 } // namespace HelloExample